@@ -61,6 +61,7 @@ public:
     void fixFlags();
 
     DockWidgetFactoryFunc m_dockWidgetFactoryFunc = nullptr;
+    DockWidgetBatchFactoryFunc m_dockWidgetBatchFactoryFunc = nullptr;
     MainWindowFactoryFunc m_mainWindowFactoryFunc = nullptr;
     DropIndicatorAllowedFunc m_dropIndicatorAllowedFunc = nullptr;
     DragAboutToStartFunc m_dragAboutToStartFunc = nullptr;
@@ -78,6 +79,7 @@ public:
     bool m_dropIndicatorsInhibited = false;
     bool m_layoutSaverStrictMode = false;
     bool m_showTabsAtBottom = false;
+    int m_maxPlaceholdersPerLayout = 0;
 };
 
 Config::Config()
@@ -163,6 +165,16 @@ DockWidgetFactoryFunc Config::dockWidgetFactoryFunc() const
     return d->m_dockWidgetFactoryFunc;
 }
 
+void Config::setDockWidgetBatchFactoryFunc(DockWidgetBatchFactoryFunc func)
+{
+    d->m_dockWidgetBatchFactoryFunc = func;
+}
+
+DockWidgetBatchFactoryFunc Config::dockWidgetBatchFactoryFunc() const
+{
+    return d->m_dockWidgetBatchFactoryFunc;
+}
+
 void Config::setMainWindowFactoryFunc(MainWindowFactoryFunc func)
 {
     d->m_mainWindowFactoryFunc = func;
@@ -457,4 +469,14 @@ bool Config::layoutSaverUsesStrictMode() const
     return d->m_layoutSaverStrictMode;
 }
 
+void Config::setMaxPlaceholdersPerLayout(int max)
+{
+    d->m_maxPlaceholdersPerLayout = max;
+}
+
+int Config::maxPlaceholdersPerLayout() const
+{
+    return d->m_maxPlaceholdersPerLayout;
+}
+
 }
@@ -35,6 +35,7 @@ class Group;
 
 typedef KDDockWidgets::Core::DockWidget *(*DockWidgetFactoryFunc)(const QString &name);
 typedef KDDockWidgets::Core::MainWindow *(*MainWindowFactoryFunc)(const QString &name, KDDockWidgets::MainWindowOptions);
+typedef void (*DockWidgetBatchFactoryFunc)(const Vector<QString> &names);
 typedef bool (*DragAboutToStartFunc)(Core::Draggable *draggable);
 typedef void (*DragEndedFunc)();
 typedef int (*DockWidgetTabIndexOverrideFunc)(Core::DockWidget *dw, Core::Group *group, int tabIndex);
@@ -132,6 +133,9 @@ public:
                                                   ///< right clicking on the tab area
         Flag_AutoHideAsTabGroups = 0x100000, ///< If tabbed dockwidgets are sent to/from sidebar, they're all sent and restored together
         Flag_DisableDoubleClick = 0x200000, ///< Do not maximize of float if a title or tab is double-clicked.
+        Flag_CoalesceTitleChanges = 0x400000, ///< Title and icon changes are propagated to title bars, tabs and
+                                              ///< windows once per event loop iteration, instead of immediately.
+                                              ///< Useful if titles change several times per second.
         Flag_Default = Flag_AeroSnapWithClientDecos ///< The defaults
     };
     Q_DECLARE_FLAGS(Flags, Flag)
@@ -229,6 +233,25 @@ public:
     /// nullptr by default
     DockWidgetFactoryFunc dockWidgetFactoryFunc() const;
 
+    /**
+     * @brief Registers a DockWidgetBatchFactoryFunc.
+     *
+     * This is optional, the default is nullptr.
+     *
+     * Called once by LayoutSaver::restoreLayout(), before anything is restored, with the names
+     * of all dock widgets the layout needs but which don't exist yet. The function should create
+     * them, with those exact names. As it gets all names up front, it can prepare the data the
+     * dock widgets need on worker threads, in parallel, and then create them on the GUI thread.
+     *
+     * Dock widgets which it doesn't create are still requested one at a time via the
+     * DockWidgetFactoryFunc.
+     */
+    void setDockWidgetBatchFactoryFunc(DockWidgetBatchFactoryFunc);
+
+    ///@brief Returns the DockWidgetBatchFactoryFunc.
+    /// nullptr by default
+    DockWidgetBatchFactoryFunc dockWidgetBatchFactoryFunc() const;
+
     ///@brief counter-part of DockWidgetFactoryFunc but for the main window.
     /// Should be rarely used. It's good practice to have the main window before restoring a layout.
     /// It's here so we can use it in the linter executable
@@ -420,6 +443,16 @@ public:
     void setLayoutSaverStrictMode(bool);
     bool layoutSaverUsesStrictMode() const;
 
+    /// @brief Sets the maximum number of placeholders a layout keeps
+    /// When a dock widget is closed, its place in the layout is remembered by a placeholder, so
+    /// it can be restored to the same position later. Apps that create and close many dock widgets
+    /// accumulate placeholders, which makes every layouting operation slower.
+    /// When over budget, the placeholders which have been hidden the longest are removed, and their
+    /// dock widgets will be restored to a default position instead.
+    /// Default is 0, which means no limit.
+    void setMaxPlaceholdersPerLayout(int);
+    int maxPlaceholdersPerLayout() const;
+
 private:
     KDDW_DELETE_COPY_CTOR(Config)
     Config();
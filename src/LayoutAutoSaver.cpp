@@ -0,0 +1,653 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Opt-in service which incrementally saves the layout to a journal file
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#include "LayoutAutoSaver.h"
+#include "LayoutSaver.h"
+#include "core/LayoutSaver_p.h"
+#include "core/Logging_p.h"
+#include "core/DelayedCall_p.h"
+#include "core/Position_p.h"
+
+#include "core/DockRegistry.h"
+#include "core/DockRegistry_p.h"
+#include "core/Platform.h"
+#include "core/FloatingWindow.h"
+#include "core/DockWidget.h"
+#include "core/DockWidget_p.h"
+#include "core/MainWindow.h"
+
+#include <kdbindings/signal.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/**
+ * Journal format:
+ *
+ * The journal is a sequence of records. Each record is a header line followed by a payload:
+ *
+ *     KDDW <kind> <flags> <payload size>\n<payload>\n
+ *
+ * kind is 'S' for a snapshot or 'D' for a delta. Both payloads are LayoutSaver::Layout json.
+ * A snapshot is what LayoutSaver::serializeLayout() returns.
+ * A delta only contains the main windows which changed, and the allDockWidgets entries which
+ * changed. Floating windows and closed dock widgets are only included if flags says so, in which
+ * case they replace the previous lists.
+ *
+ * The journal always starts with a snapshot. Compaction writes a new snapshot into a temporary
+ * file and renames it over the journal.
+ */
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+namespace {
+
+enum JournalFlag {
+    JournalFlag_None = 0,
+    JournalFlag_FloatingWindows = 1,
+    JournalFlag_ClosedDockWidgets = 2
+};
+
+struct JournalRecord
+{
+    std::string header;
+    QByteArray payload;
+    bool isSnapshot = false;
+};
+
+JournalRecord createRecord(char kind, int flags, const QByteArray &payload)
+{
+    JournalRecord record;
+    record.header = std::string("KDDW ") + kind + ' ' + std::to_string(flags) + ' '
+        + std::to_string(payload.size()) + '\n';
+    record.payload = payload;
+    record.isSnapshot = kind == 'S';
+    return record;
+}
+
+}
+
+class LayoutAutoSaver::Private
+{
+public:
+    explicit Private(LayoutAutoSaver *qq, const QString &journalFilename);
+    ~Private();
+
+    void onLayoutChanged(Core::Layout *);
+    void scheduleFlush();
+    bool hasPendingChanges() const;
+    void clearPendingChanges();
+
+    /// Serializes @p dw the same way LayoutSaver does, including its last position
+    LayoutSaver::DockWidget::Ptr serializeDockWidget(Core::DockWidget *dw) const;
+
+    void enqueue(JournalRecord &&);
+    void writeRecord(const JournalRecord &);
+
+    /// Renames @p from to @p to, replacing it. Returns false on failure.
+    static bool replaceFile(const std::string &from, const std::string &to);
+    void runWriter();
+
+    LayoutAutoSaver *const q;
+    DockRegistry *const m_dockRegistry;
+    const QString m_journalFilename;
+    const std::string m_journalPath;
+
+    bool m_enabled = true;
+    bool m_flushScheduled = false;
+    bool m_needsSnapshot = true;
+    bool m_floatingDirty = false;
+    int m_flushDelay = 500;
+    int m_compactionThreshold = 100;
+    int m_numDeltas = 0;
+
+    std::unordered_set<QString> m_dirtyMainWindows;
+
+    // What's already in the journal. Used to know what changed.
+    Vector<QString> m_journaledMainWindows;
+    std::unordered_map<QString, QByteArray> m_journaledDockWidgets;
+
+    KDBindings::ScopedConnection m_layoutChangedConnection;
+
+    // Delayed calls check this, as they might fire after we're destroyed
+    const std::shared_ptr<bool> m_guard = std::make_shared<bool>(true);
+
+    // Worker thread state, protected by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<JournalRecord> m_queue;
+    bool m_writing = false;
+    bool m_quit = false;
+    std::thread m_writerThread;
+};
+
+namespace {
+
+class DelayedAutoSaveFlush : public DelayedCall
+{
+public:
+    DelayedAutoSaveFlush(LayoutAutoSaver *saver, const std::shared_ptr<bool> &guard)
+        : m_saver(saver)
+        , m_guard(guard)
+    {
+    }
+
+    void call() override
+    {
+        if (m_guard.expired())
+            return;
+
+        m_saver->dptr()->m_flushScheduled = false;
+        m_saver->flush();
+    }
+
+    KDDW_DELETE_COPY_CTOR(DelayedAutoSaveFlush)
+private:
+    LayoutAutoSaver *const m_saver;
+    const std::weak_ptr<bool> m_guard;
+};
+
+}
+
+LayoutAutoSaver::Private::Private(LayoutAutoSaver *qq, const QString &journalFilename)
+    : q(qq)
+    , m_dockRegistry(DockRegistry::self())
+    , m_journalFilename(journalFilename)
+    , m_journalPath(journalFilename.toStdString())
+{
+    m_layoutChangedConnection =
+        m_dockRegistry->dptr()->layoutChanged.connect([this](Core::Layout *layout) { onLayoutChanged(layout); });
+
+    m_writerThread = std::thread([this] { runWriter(); });
+}
+
+LayoutAutoSaver::Private::~Private()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+
+    m_condition.notify_all();
+    m_writerThread.join();
+}
+
+void LayoutAutoSaver::Private::onLayoutChanged(Core::Layout *layout)
+{
+    if (!m_enabled)
+        return;
+
+    if (LayoutSaver::restoreInProgress()) {
+        // Everything is changing, a delta wouldn't be any smaller
+        m_needsSnapshot = true;
+    } else if (!layout) {
+        m_floatingDirty = true;
+    } else {
+        // Only compare pointers, as the layout might be being destroyed
+        bool found = false;
+        for (Core::MainWindow *mw : m_dockRegistry->mainwindows()) {
+            if (mw->layout() == layout) {
+                m_dirtyMainWindows.insert(mw->uniqueName());
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+            m_floatingDirty = true;
+    }
+
+    scheduleFlush();
+}
+
+void LayoutAutoSaver::Private::scheduleFlush()
+{
+    if (m_flushScheduled)
+        return;
+
+    m_flushScheduled = true;
+    Platform::instance()->runDelayed(m_flushDelay, new DelayedAutoSaveFlush(q, m_guard));
+}
+
+bool LayoutAutoSaver::Private::hasPendingChanges() const
+{
+    return m_needsSnapshot || m_floatingDirty || !m_dirtyMainWindows.empty();
+}
+
+void LayoutAutoSaver::Private::clearPendingChanges()
+{
+    m_needsSnapshot = false;
+    m_floatingDirty = false;
+    m_dirtyMainWindows.clear();
+}
+
+LayoutSaver::DockWidget::Ptr LayoutAutoSaver::Private::serializeDockWidget(Core::DockWidget *dockWidget) const
+{
+    auto dw = dockWidget->d->serialize();
+    dw->lastPosition = dockWidget->d->lastPosition()->serialize();
+    return dw;
+}
+
+void LayoutAutoSaver::Private::enqueue(JournalRecord &&record)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(record));
+    }
+
+    m_condition.notify_all();
+}
+
+void LayoutAutoSaver::Private::writeRecord(const JournalRecord &record)
+{
+    // Snapshots replace the journal. Write them into a temporary file first, so a crash while
+    // writing doesn't lose the previous journal.
+    const std::string path = record.isSnapshot ? m_journalPath + ".tmp" : m_journalPath;
+    std::ofstream file(path, record.isSnapshot ? std::ios::binary | std::ios::trunc : std::ios::binary | std::ios::app);
+    if (!file.is_open()) {
+        KDDW_ERROR("LayoutAutoSaver: Failed to open {}", QString::fromStdString(path));
+        return;
+    }
+
+    file.write(record.header.data(), std::streamsize(record.header.size()));
+    file.write(record.payload.constData(), std::streamsize(record.payload.size()));
+    file.put('\n');
+    file.close();
+
+    if (record.isSnapshot && !replaceFile(path, m_journalPath))
+        KDDW_ERROR("LayoutAutoSaver: Failed to replace {}", m_journalFilename);
+}
+
+/*static*/
+bool LayoutAutoSaver::Private::replaceFile(const std::string &from, const std::string &to)
+{
+#ifdef _WIN32
+    // std::rename() doesn't replace existing files on Windows, and removing the target first
+    // would leave no journal if we crash in between
+    const auto toWide = [](const std::string &str) {
+        const int len = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+        std::wstring result(size_t(std::max(len, 1)), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, result.data(), len);
+        return result;
+    };
+
+    return MoveFileExW(toWide(from).c_str(), toWide(to).c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    // Atomically replaces the target
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+void LayoutAutoSaver::Private::runWriter()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            // Only quit once everything was written
+            break;
+        }
+
+        JournalRecord record = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_writing = true;
+
+        lock.unlock();
+        writeRecord(record);
+        lock.lock();
+
+        m_writing = false;
+        m_condition.notify_all();
+    }
+}
+
+LayoutAutoSaver::LayoutAutoSaver(const QString &journalFilename)
+    : d(new Private(this, journalFilename))
+{
+    d->m_dockRegistry->registerLayoutSaver();
+
+    // The first record is always a full snapshot
+    d->scheduleFlush();
+}
+
+LayoutAutoSaver::~LayoutAutoSaver()
+{
+    DockRegistry *dockRegistry = d->m_dockRegistry;
+    delete d;
+    dockRegistry->unregisterLayoutSaver();
+}
+
+LayoutAutoSaver::Private *LayoutAutoSaver::dptr() const
+{
+    return d;
+}
+
+QString LayoutAutoSaver::journalFilename() const
+{
+    return d->m_journalFilename;
+}
+
+void LayoutAutoSaver::setEnabled(bool enabled)
+{
+    if (d->m_enabled == enabled)
+        return;
+
+    d->m_enabled = enabled;
+    if (enabled) {
+        // We missed changes while disabled
+        d->m_needsSnapshot = true;
+        d->scheduleFlush();
+    } else {
+        d->clearPendingChanges();
+    }
+}
+
+bool LayoutAutoSaver::isEnabled() const
+{
+    return d->m_enabled;
+}
+
+void LayoutAutoSaver::setFlushDelay(int ms)
+{
+    d->m_flushDelay = ms;
+}
+
+int LayoutAutoSaver::flushDelay() const
+{
+    return d->m_flushDelay;
+}
+
+void LayoutAutoSaver::setCompactionThreshold(int numDeltas)
+{
+    d->m_compactionThreshold = numDeltas;
+}
+
+int LayoutAutoSaver::compactionThreshold() const
+{
+    return d->m_compactionThreshold;
+}
+
+int LayoutAutoSaver::numDeltas() const
+{
+    return d->m_numDeltas;
+}
+
+void LayoutAutoSaver::flush()
+{
+    if (!d->m_enabled || !d->hasPendingChanges())
+        return;
+
+    if (LayoutSaver::restoreInProgress()) {
+        d->m_needsSnapshot = true;
+        d->scheduleFlush();
+        return;
+    }
+
+    const auto mainWindows = d->m_dockRegistry->mainwindows();
+    Vector<QString> mainWindowNames;
+    mainWindowNames.reserve(mainWindows.size());
+    for (Core::MainWindow *mw : mainWindows)
+        mainWindowNames.push_back(mw->uniqueName());
+
+    // A delta can't express a main window being removed, as restoring requires all main windows
+    // in the layout to exist. Do a snapshot instead.
+    if (d->m_needsSnapshot || d->m_numDeltas >= d->m_compactionThreshold
+        || mainWindowNames != d->m_journaledMainWindows) {
+        compact();
+        return;
+    }
+
+    if (!d->m_dockRegistry->isSane()) {
+        KDDW_ERROR("LayoutAutoSaver: Refusing to save this layout. Check previous warnings.");
+        return;
+    }
+
+    // Same simplification as LayoutSaver::serializeLayout()
+    d->m_dockRegistry->ensureAllFloatingWidgetsAreMorphed();
+
+    int flags = JournalFlag_None;
+    QByteArray payload;
+    {
+        LayoutSaver::Layout delta;
+
+        for (Core::MainWindow *mw : mainWindows) {
+            if (d->m_dirtyMainWindows.count(mw->uniqueName()) > 0)
+                delta.mainWindows.push_back(mw->serialize());
+        }
+
+        if (d->m_floatingDirty) {
+            flags |= JournalFlag_FloatingWindows | JournalFlag_ClosedDockWidgets;
+
+            const auto floatingWindows =
+                d->m_dockRegistry->floatingWindows(/*includeBeingDeleted=*/false, /*honourSkipped=*/true);
+            for (Core::FloatingWindow *fw : floatingWindows)
+                delta.floatingWindows.push_back(fw->serialize());
+
+            const auto closedDockWidgets = d->m_dockRegistry->closedDockwidgets(/*honourSkipped=*/true);
+            for (Core::DockWidget *dw : closedDockWidgets)
+                delta.closedDockWidgets.push_back(dw->d->serialize());
+        }
+
+        // Positions are cheap to serialize but can change whenever something else changes, so
+        // instead of tracking them just compare against what's in the journal
+        for (Core::DockWidget *dockWidget : d->m_dockRegistry->dockwidgets()) {
+            if (dockWidget->skipsRestore())
+                continue;
+
+            auto dw = d->serializeDockWidget(dockWidget);
+            QByteArray json = dw->toJson();
+            auto it = d->m_journaledDockWidgets.find(dw->uniqueName);
+            if (it == d->m_journaledDockWidgets.end()) {
+                d->m_journaledDockWidgets.emplace(dw->uniqueName, std::move(json));
+            } else if (it->second != json) {
+                it->second = std::move(json);
+            } else {
+                continue;
+            }
+
+            delta.allDockWidgets.push_back(dw);
+        }
+
+        d->clearPendingChanges();
+
+        if (delta.mainWindows.isEmpty() && delta.allDockWidgets.isEmpty() && flags == JournalFlag_None)
+            return;
+
+        payload = delta.toJson();
+    }
+
+    d->enqueue(createRecord('D', flags, payload));
+    ++d->m_numDeltas;
+}
+
+void LayoutAutoSaver::compact()
+{
+    if (LayoutSaver::restoreInProgress()) {
+        d->m_needsSnapshot = true;
+        d->scheduleFlush();
+        return;
+    }
+
+    QByteArray snapshot;
+    {
+        LayoutSaver saver;
+        snapshot = saver.serializeLayout();
+    }
+
+    if (snapshot.isEmpty()) {
+        // Not sane, LayoutSaver already warned
+        return;
+    }
+
+    d->clearPendingChanges();
+    d->m_numDeltas = 0;
+
+    d->m_journaledMainWindows.clear();
+    for (Core::MainWindow *mw : d->m_dockRegistry->mainwindows())
+        d->m_journaledMainWindows.push_back(mw->uniqueName());
+
+    d->m_journaledDockWidgets.clear();
+    for (Core::DockWidget *dockWidget : d->m_dockRegistry->dockwidgets()) {
+        if (!dockWidget->skipsRestore()) {
+            auto dw = d->serializeDockWidget(dockWidget);
+            d->m_journaledDockWidgets.emplace(dw->uniqueName, dw->toJson());
+        }
+    }
+
+    d->enqueue(createRecord('S', JournalFlag_None, snapshot));
+}
+
+void LayoutAutoSaver::waitForWrites()
+{
+    std::unique_lock<std::mutex> lock(d->m_mutex);
+    d->m_condition.wait(lock, [this] { return d->m_queue.empty() && !d->m_writing; });
+}
+
+/*static*/
+QByteArray LayoutAutoSaver::layoutFromJournal(const QString &journalFilename)
+{
+    // A snapshot is written to a temporary file and then renamed over the journal. If there's
+    // no journal then renaming failed, and the temporary file has the most recent layout.
+    const auto fileExists = [](const QString &filename) {
+        return std::ifstream(filename.toStdString(), std::ios::binary).is_open();
+    };
+    const QString tmpFilename = journalFilename + QStringLiteral(".tmp");
+    const bool useTmp = !fileExists(journalFilename) && fileExists(tmpFilename);
+
+    bool ok = false;
+    const QByteArray data = Platform::instance()->readFile(useTmp ? tmpFilename : journalFilename, /*by-ref*/ ok);
+    if (!ok)
+        return {};
+
+    // The merged layout. LayoutSaver::Layout can't be used to hold it, as only one can exist at
+    // a time.
+    int serializationVersion = 0;
+    bool hasSnapshot = false;
+    LayoutSaver::MainWindow::List mainWindows;
+    LayoutSaver::FloatingWindow::List floatingWindows;
+    LayoutSaver::DockWidget::List closedDockWidgets;
+    LayoutSaver::DockWidget::List allDockWidgets;
+    std::unordered_map<QString, int> allDockWidgetsIndexes;
+
+    LayoutSaver::DockWidget::s_dockWidgets.clear();
+
+    const char *const begin = data.constData();
+    const size_t size = size_t(data.size());
+    size_t pos = 0;
+    while (pos < size) {
+        const std::string remaining(begin + pos, std::min<size_t>(size - pos, 64));
+        const size_t headerEnd = remaining.find('\n');
+        char kind = 0;
+        int flags = 0;
+        unsigned long payloadSize = 0;
+        if (headerEnd == std::string::npos
+            || std::sscanf(remaining.c_str(), "KDDW %c %d %lu", &kind, &flags, &payloadSize) != 3) {
+            KDDW_ERROR("LayoutAutoSaver: Corrupt journal record at offset {}", int(pos));
+            break;
+        }
+
+        const size_t payloadBegin = pos + headerEnd + 1;
+        if (payloadBegin + payloadSize > size) {
+            // The application probably crashed while writing this record
+            KDDW_DEBUG("LayoutAutoSaver: Ignoring truncated journal record at offset {}", int(pos));
+            break;
+        }
+
+        const QByteArray payload = QByteArray::fromStdString(std::string(begin + payloadBegin, payloadSize));
+        pos = payloadBegin + payloadSize + 1;
+
+        LayoutSaver::Layout record;
+        if (!record.fromJson(payload)) {
+            KDDW_ERROR("LayoutAutoSaver: Failed to parse journal record");
+            break;
+        }
+
+        if (kind == 'S') {
+            hasSnapshot = true;
+            serializationVersion = record.serializationVersion;
+            mainWindows = record.mainWindows;
+            floatingWindows = record.floatingWindows;
+            closedDockWidgets = record.closedDockWidgets;
+            allDockWidgets.clear();
+            allDockWidgetsIndexes.clear();
+        } else if (!hasSnapshot) {
+            KDDW_ERROR("LayoutAutoSaver: Journal doesn't start with a snapshot");
+            return {};
+        } else {
+            for (const auto &mw : std::as_const(record.mainWindows)) {
+                auto it = std::find_if(mainWindows.begin(), mainWindows.end(), [&mw](const auto &m) {
+                    return m.uniqueName == mw.uniqueName;
+                });
+                if (it == mainWindows.end())
+                    mainWindows.push_back(mw);
+                else
+                    *it = mw;
+            }
+
+            if (flags & JournalFlag_FloatingWindows)
+                floatingWindows = record.floatingWindows;
+            if (flags & JournalFlag_ClosedDockWidgets)
+                closedDockWidgets = record.closedDockWidgets;
+        }
+
+        // These are shared per name, the latest record already updated them, just keep the order
+        for (const auto &dw : std::as_const(record.allDockWidgets)) {
+            if (allDockWidgetsIndexes.count(dw->uniqueName) == 0) {
+                allDockWidgetsIndexes.emplace(dw->uniqueName, int(allDockWidgets.size()));
+                allDockWidgets.push_back(dw);
+            }
+        }
+    }
+
+    if (!hasSnapshot)
+        return {};
+
+    LayoutSaver::Layout layout;
+    layout.serializationVersion = serializationVersion;
+    layout.mainWindows = mainWindows;
+    layout.floatingWindows = floatingWindows;
+    layout.closedDockWidgets = closedDockWidgets;
+    layout.allDockWidgets = allDockWidgets;
+    return layout.toJson();
+}
+
+/*static*/
+bool LayoutAutoSaver::restoreFromJournal(const QString &journalFilename, RestoreOptions options)
+{
+    const QByteArray layout = layoutFromJournal(journalFilename);
+    if (layout.isEmpty())
+        return false;
+
+    LayoutSaver saver(options);
+    return saver.restoreLayout(layout);
+}
@@ -0,0 +1,116 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#ifndef KD_LAYOUTAUTOSAVER_H
+#define KD_LAYOUTAUTOSAVER_H
+
+/**
+ * @file
+ * @brief Opt-in service which incrementally saves the layout to a journal file
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#include "kddockwidgets/docks_export.h"
+
+#include "kddockwidgets/KDDockWidgets.h"
+
+QT_BEGIN_NAMESPACE
+class QByteArray;
+QT_END_NAMESPACE
+
+namespace KDDockWidgets {
+
+/**
+ * @brief LayoutAutoSaver continuously saves the layout, so it can be recovered after a crash.
+ *
+ * A full LayoutSaver::serializeLayout() is too expensive to call on every change. Instead,
+ * LayoutAutoSaver listens to layout changes (dock widgets added, removed, floated, closed or
+ * separators moved) and appends small delta records to a journal file, containing only the
+ * main windows and dock widgets which changed. Every compactionThreshold() deltas, the journal is
+ * replaced by a full snapshot.
+ *
+ * Changes are coalesced and saved flushDelay() milliseconds after the first one.
+ * Only serialization happens in the GUI thread, the file is written by a worker thread.
+ *
+ * Example:
+ *     // At startup, recover the previous session, if any:
+ *     LayoutAutoSaver::restoreFromJournal(filename);
+ *
+ *     // Keep saving the layout while the application runs:
+ *     LayoutAutoSaver autoSaver(filename);
+ *
+ * Note that floating windows being moved or main windows being resized aren't journaled by
+ * themselves. They are saved with the next change or snapshot.
+ */
+class DOCKS_EXPORT LayoutAutoSaver
+{
+public:
+    ///@brief Constructor. Starts journaling to @p journalFilename.
+    /// The file is only truncated by the first flush, which writes a snapshot, so until then a
+    /// previous session's journal can still be recovered from it.
+    explicit LayoutAutoSaver(const QString &journalFilename);
+
+    ///@brief Destructor. Waits for pending writes to finish.
+    ~LayoutAutoSaver();
+
+    ///@brief Returns the journal file name
+    QString journalFilename() const;
+
+    ///@brief Enables or disables journaling. Enabled by default.
+    void setEnabled(bool);
+    bool isEnabled() const;
+
+    ///@brief Sets how many milliseconds to wait after a change before saving it. Default is 500.
+    void setFlushDelay(int ms);
+    int flushDelay() const;
+
+    ///@brief Sets after how many deltas the journal is compacted into a snapshot. Default is 100.
+    void setCompactionThreshold(int numDeltas);
+    int compactionThreshold() const;
+
+    ///@brief Returns how many deltas were appended since the last snapshot
+    int numDeltas() const;
+
+    ///@brief Saves pending changes right away, instead of waiting for flushDelay()
+    void flush();
+
+    ///@brief Replaces the journal with a full snapshot of the current layout
+    void compact();
+
+    ///@brief Blocks until the worker thread has written everything to disk
+    void waitForWrites();
+
+    /**
+     * @brief Reads a journal and returns the layout it represents.
+     * The result can be passed to LayoutSaver::restoreLayout().
+     * Returns an empty byte array if the journal can't be read or has no snapshot.
+     * A truncated last record, which can happen if the application crashed while writing it, is
+     * ignored.
+     */
+    static QByteArray layoutFromJournal(const QString &journalFilename);
+
+    ///@brief Convenience which restores the layout saved in a journal
+    ///@return true on success
+    static bool restoreFromJournal(const QString &journalFilename,
+                                   RestoreOptions options = RestoreOption_None);
+
+    /// @internal Returns the private-impl. Not intended for public use.
+    class Private;
+    Private *dptr() const;
+
+private:
+    KDDW_DELETE_COPY_CTOR(LayoutAutoSaver)
+    Private *const d;
+};
+}
+
+#endif
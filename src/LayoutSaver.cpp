@@ -24,6 +24,7 @@
 #include "core/Position_p.h"
 #include "core/Utils_p.h"
 #include "core/View_p.h"
+#include "core/Tracing_p.h"
 
 #include "core/DockRegistry.h"
 #include "core/Platform.h"
@@ -36,9 +37,11 @@
 #include "core/nlohmann_helpers_p.h"
 #include "core/layouting/Item_p.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <set>
 #include <utility>
 
 /**
@@ -64,7 +67,7 @@
 using namespace KDDockWidgets;
 using namespace KDDockWidgets::Core;
 
-std::map<QString, LayoutSaver::DockWidget::Ptr> LayoutSaver::DockWidget::s_dockWidgets;
+std::unordered_map<int, LayoutSaver::DockWidget::Ptr> LayoutSaver::DockWidget::s_dockWidgets;
 LayoutSaver::Layout *LayoutSaver::Layout::s_currentLayoutBeingRestored = nullptr;
 std::unordered_map<QString, std::shared_ptr<KDDockWidgets::Positions>> LayoutSaver::Private::s_unrestoredPositions;
 std::unordered_map<QString, CloseReason> LayoutSaver::Private::s_unrestoredProperties;
@@ -369,19 +372,26 @@ static void to_json(nlohmann::json &json, const typename LayoutSaver::DockWidget
     }
 }
 
+/// Returns the dock widget described by @p json, or nullptr if it has no name
+static LayoutSaver::DockWidget::Ptr dockWidgetFromJson(const nlohmann::json &json)
+{
+    auto it = json.find("uniqueName");
+    if (it == json.end()) {
+        KDDW_ERROR("Unexpected no uniqueName");
+        return {};
+    }
+    QString uniqueName = it->get<QString>();
+    auto dw = LayoutSaver::DockWidget::dockWidgetForName(uniqueName);
+    from_json(json, *dw);
+    return dw;
+}
+
 static void from_json(const nlohmann::json &json, typename LayoutSaver::DockWidget::List &list)
 {
     list.clear();
     for (const auto &v : json) {
-        auto it = v.find("uniqueName");
-        if (it == v.end()) {
-            KDDW_ERROR("Unexpected no uniqueName");
-            continue;
-        }
-        QString uniqueName = it->get<QString>();
-        auto dw = LayoutSaver::DockWidget::dockWidgetForName(uniqueName);
-        from_json(v, *dw);
-        list.push_back(dw);
+        if (auto dw = dockWidgetFromJson(v))
+            list.push_back(dw);
     }
 }
 
@@ -427,57 +437,65 @@ bool LayoutSaver::restoreFromFile(const QString &jsonFilename)
 
 QByteArray LayoutSaver::serializeLayout() const
 {
-    if (!d->m_dockRegistry->isSane()) {
-        KDDW_ERROR("Refusing to serialize this layout. Check previous warnings.");
+    LayoutSaver::Layout layout;
+    if (!d->serializeTo(layout))
         return {};
-    }
 
-    LayoutSaver::Layout layout;
+    return layout.toJson();
+}
+
+bool LayoutSaver::Private::serializeTo(LayoutSaver::Layout &layout)
+{
+    if (!m_dockRegistry->isSane()) {
+        KDDW_ERROR("Refusing to serialize this layout. Check previous warnings.");
+        return false;
+    }
 
     // Just a simplification. One less type of windows to handle.
-    d->m_dockRegistry->ensureAllFloatingWidgetsAreMorphed();
+    m_dockRegistry->ensureAllFloatingWidgetsAreMorphed();
 
-    const auto mainWindows = d->m_dockRegistry->mainwindows();
+    const auto mainWindows = m_dockRegistry->mainwindows();
     layout.mainWindows.reserve(mainWindows.size());
     for (auto mainWindow : mainWindows) {
-        if (d->matchesAffinity(mainWindow->affinities()))
+        if (matchesAffinity(mainWindow->affinities()))
             layout.mainWindows.push_back(mainWindow->serialize());
     }
 
     const Vector<Core::FloatingWindow *> floatingWindows =
-        d->m_dockRegistry->floatingWindows(/*includeBeingDeleted=*/false, /*honourSkipped=*/true);
+        m_dockRegistry->floatingWindows(/*includeBeingDeleted=*/false, /*honourSkipped=*/true);
     layout.floatingWindows.reserve(floatingWindows.size());
     for (Core::FloatingWindow *floatingWindow : floatingWindows) {
-        if (d->matchesAffinity(floatingWindow->affinities()))
+        if (matchesAffinity(floatingWindow->affinities()))
             layout.floatingWindows.push_back(floatingWindow->serialize());
     }
 
     // Closed dock widgets also have interesting things to save, like geometry and placeholder info
-    const Core::DockWidget::List closedDockWidgets = d->m_dockRegistry->closedDockwidgets(/*honourSkipped=*/true);
+    const Core::DockWidget::List closedDockWidgets = m_dockRegistry->closedDockwidgets(/*honourSkipped=*/true);
     layout.closedDockWidgets.reserve(closedDockWidgets.size());
     for (Core::DockWidget *dockWidget : closedDockWidgets) {
-        if (d->matchesAffinity(dockWidget->affinities()))
+        if (matchesAffinity(dockWidget->affinities()))
             layout.closedDockWidgets.push_back(dockWidget->d->serialize());
     }
 
     // Save the placeholder info. We do it last, as we also restore it last, since we need all items
     // to be created before restoring the placeholders
 
-    const Core::DockWidget::List dockWidgets = d->m_dockRegistry->dockwidgets();
+    const Core::DockWidget::List dockWidgets = m_dockRegistry->dockwidgets();
     layout.allDockWidgets.reserve(dockWidgets.size());
     for (Core::DockWidget *dockWidget : dockWidgets) {
-        if (!dockWidget->skipsRestore() && d->matchesAffinity(dockWidget->affinities())) {
+        if (!dockWidget->skipsRestore() && matchesAffinity(dockWidget->affinities())) {
             auto dw = dockWidget->d->serialize();
             dw->lastPosition = dockWidget->d->lastPosition()->serialize();
             layout.allDockWidgets.push_back(dw);
         }
     }
 
-    return layout.toJson();
+    return true;
 }
 
 bool LayoutSaver::restoreLayout(const QByteArray &data)
 {
+    KDDW_SCOPED_TRACE("layoutsaver", "LayoutSaver::restoreLayout");
     LayoutSaver::DockWidget::s_dockWidgets.clear();
     d->clearRestoredProperty();
     if (data.isEmpty())
@@ -501,6 +519,7 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
         LayoutSaver *const m_saver;
     };
 
+    KDDW_SCOPED_TRACE_PHASES("layoutsaver", "LayoutSaver::restoreLayout: parse");
     GroupCleanup cleanup(this);
     LayoutSaver::Layout layout;
     if (!layout.fromJson(data)) {
@@ -512,8 +531,11 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
         return false;
     }
 
+    KDDW_TRACE_PHASE("LayoutSaver::restoreLayout: prepare");
     layout.scaleSizes(d->m_restoreOptions);
 
+    d->createMissingDockWidgets(layout);
+
     d->floatWidgetsWhichSkipRestore(layout.mainWindowNames());
     d->floatUnknownWidgets(layout);
 
@@ -527,6 +549,7 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
                              d->m_affinityNames);
 
     // 1. Restore main windows
+    KDDW_TRACE_PHASE("LayoutSaver::restoreLayout: main windows");
     for (const LayoutSaver::MainWindow &mw : std::as_const(layout.mainWindows)) {
         auto mainWindow = d->m_dockRegistry->mainWindowByName(mw.uniqueName);
         if (!mainWindow) {
@@ -558,6 +581,7 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
     }
 
     // 2. Restore FloatingWindows
+    KDDW_TRACE_PHASE("LayoutSaver::restoreLayout: floating windows");
     for (LayoutSaver::FloatingWindow &fw : layout.floatingWindows) {
         if (!d->matchesAffinity(fw.affinities) || fw.skipsRestore())
             continue;
@@ -580,6 +604,7 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
 
     // 3. Restore closed dock widgets. They remain closed but acquire geometry and placeholder
     // properties
+    KDDW_TRACE_PHASE("LayoutSaver::restoreLayout: closed dock widgets");
     for (const auto &dw : std::as_const(layout.closedDockWidgets)) {
         if (d->matchesAffinity(dw->affinities)) {
             Core::DockWidget::deserialize(dw);
@@ -590,6 +615,7 @@ bool LayoutSaver::restoreLayout(const QByteArray &data)
     LayoutSaver::Private::s_unrestoredProperties.clear();
 
     // 4. Restore the placeholder info, now that the Items have been created
+    KDDW_TRACE_PHASE("LayoutSaver::restoreLayout: placeholders");
     for (const auto &dw : std::as_const(layout.allDockWidgets)) {
         if (!d->matchesAffinity(dw->affinities))
             continue;
@@ -745,6 +771,23 @@ void LayoutSaver::Private::floatUnknownWidgets(const LayoutSaver::Layout &layout
     }
 }
 
+void LayoutSaver::Private::createMissingDockWidgets(const LayoutSaver::Layout &layout) const
+{
+    auto batchFactoryFunc = Config::self().dockWidgetBatchFactoryFunc();
+    if (!batchFactoryFunc)
+        return;
+
+    Vector<QString> names;
+    for (const auto &dw : std::as_const(layout.allDockWidgets)) {
+        if (matchesAffinity(dw->affinities)
+            && !m_dockRegistry->dockByName(dw->uniqueName, DockRegistry::DockByNameFlag::ConsultRemapping))
+            names.push_back(dw->uniqueName);
+    }
+
+    if (!names.isEmpty())
+        batchFactoryFunc(names);
+}
+
 void LayoutSaver::Private::deleteEmptyGroups() const
 {
     // After a restore it can happen that some DockWidgets didn't exist, so weren't restored.
@@ -857,51 +900,558 @@ Vector<QString> LayoutSaver::sideBarDockWidgetsInLayout(const QByteArray &serial
     return names;
 }
 
-namespace KDDockWidgets {
-static void to_json(nlohmann::json &j, const LayoutSaver::Layout &layout)
+namespace {
+
+/// The parts of a LayoutSaver::Layout which LayoutSaver::diffLayouts() compares
+struct LayoutSummary
+{
+    struct Dock
+    {
+        bool isOpen = false;
+        QString location; // The window or side bar, and the dock widgets tabbed together
+        int tabIndex = -1;
+        bool isCurrentTab = false;
+        Rect geometry;
+    };
+
+    struct Window
+    {
+        Rect geometry;
+        KDDockWidgets::WindowState windowState = KDDockWidgets::WindowState::None;
+        bool isVisible = false;
+        Vector<QString> dockWidgets; // Only for floating windows
+
+        bool operator!=(const Window &other) const
+        {
+            return geometry != other.geometry || windowState != other.windowState
+                || isVisible != other.isVisible;
+        }
+    };
+
+    explicit LayoutSummary(const LayoutSaver::Layout &layout)
+    {
+        std::set<QString> closedDockWidgets;
+        for (const auto &dw : layout.closedDockWidgets)
+            closedDockWidgets.insert(dw->uniqueName);
+
+        for (const auto &dw : layout.allDockWidgets)
+            docks[dw->uniqueName].isOpen = closedDockWidgets.count(dw->uniqueName) == 0;
+
+        for (const LayoutSaver::MainWindow &mw : layout.mainWindows) {
+            mainWindows[mw.uniqueName] = { mw.geometry, mw.windowState, mw.isVisible, {} };
+            addGroups(mw.multiSplitterLayout, QStringLiteral("MainWindow:") + mw.uniqueName);
+
+            for (const auto &it : mw.dockWidgetsPerSideBar) {
+                const QString location = QStringLiteral("SideBar:") + mw.uniqueName
+                    + QStringLiteral(":") + QString::number(int(it.first));
+                for (const QString &name : it.second)
+                    docks[name].location = location;
+            }
+        }
+
+        // Floating windows don't have a name, so they are identified by their dock widgets
+        for (const LayoutSaver::FloatingWindow &fw : layout.floatingWindows) {
+            Vector<QString> names;
+            for (const auto &it : fw.multiSplitterLayout.groups) {
+                for (const auto &dw : it.second.dockWidgets)
+                    names.push_back(dw->uniqueName);
+            }
+            std::sort(names.begin(), names.end());
+
+            QString key;
+            for (const QString &name : std::as_const(names))
+                key += name + QStringLiteral(";");
+
+            floatingWindows[key] = { fw.geometry, fw.windowState, fw.isVisible, names };
+            addGroups(fw.multiSplitterLayout, QStringLiteral("FloatingWindow:") + key);
+        }
+    }
+
+    void addGroups(const LayoutSaver::MultiSplitter &multiSplitter, const QString &window)
+    {
+        for (const auto &it : multiSplitter.groups) {
+            const LayoutSaver::Group &group = it.second;
+
+            QString location = window + QStringLiteral("/");
+            for (const auto &dw : group.dockWidgets)
+                location += dw->uniqueName + QStringLiteral(";");
+
+            const int numDockWidgets = int(group.dockWidgets.size());
+            for (int i = 0; i < numDockWidgets; ++i) {
+                Dock &dock = docks[group.dockWidgets.at(i)->uniqueName];
+                dock.location = location;
+                dock.tabIndex = i;
+                dock.isCurrentTab = i == group.currentTabIndex;
+                dock.geometry = group.geometry; // Relative to the window
+            }
+        }
+    }
+
+    // std::map, so the diff comes out sorted
+    std::map<QString, Dock> docks;
+    std::map<QString, Window> mainWindows;
+    std::map<QString, Window> floatingWindows;
+};
+
+LayoutSaver::Diff diffSummaries(const LayoutSummary &from, const LayoutSummary &to)
 {
-    j["serializationVersion"] = layout.serializationVersion;
-    j["mainWindows"] = layout.mainWindows;
-    j["floatingWindows"] = layout.floatingWindows;
-    j["closedDockWidgets"] = ::dockWidgetNames(layout.closedDockWidgets);
-    j["allDockWidgets"] = layout.allDockWidgets;
-    j["screenInfo"] = layout.screenInfo;
+    LayoutSaver::Diff diff;
+    diff.isValid = true;
+
+    static const LayoutSummary::Dock s_closedDock;
+    auto dockIn = [](const LayoutSummary &summary, const QString &name) -> const LayoutSummary::Dock & {
+        auto it = summary.docks.find(name);
+        return it == summary.docks.cend() ? s_closedDock : it->second;
+    };
+
+    std::set<QString> names;
+    for (const auto &it : from.docks)
+        names.insert(it.first);
+    for (const auto &it : to.docks)
+        names.insert(it.first);
+
+    for (const QString &name : names) {
+        const LayoutSummary::Dock &before = dockIn(from, name);
+        const LayoutSummary::Dock &after = dockIn(to, name);
+
+        if (!before.isOpen && !after.isOpen) {
+            // Side bar dock widgets aren't open, but can still move between side bars
+            if (before.location != after.location)
+                diff.movedDockWidgets.push_back(name);
+        } else if (!before.isOpen) {
+            diff.openedDockWidgets.push_back(name);
+        } else if (!after.isOpen) {
+            diff.closedDockWidgets.push_back(name);
+        } else if (before.location != after.location || before.tabIndex != after.tabIndex
+                   || before.geometry.topLeft() != after.geometry.topLeft()) {
+            diff.movedDockWidgets.push_back(name);
+        } else if (before.geometry.size() != after.geometry.size()) {
+            diff.resizedDockWidgets.push_back(name);
+        } else if (!before.isCurrentTab && after.isCurrentTab) {
+            diff.newCurrentTabs.push_back(name);
+        }
+    }
+
+    for (const auto &it : to.mainWindows) {
+        auto before = from.mainWindows.find(it.first);
+        if (before != from.mainWindows.cend() && before->second != it.second)
+            diff.changedMainWindows.push_back(it.first);
+    }
+
+    // A floating window which got or lost dock widgets is a different window, those dock widgets
+    // are reported as moved instead
+    for (const auto &it : to.floatingWindows) {
+        auto before = from.floatingWindows.find(it.first);
+        if (before != from.floatingWindows.cend() && before->second != it.second)
+            diff.changedFloatingWindows.push_back(it.second.dockWidgets);
+    }
+
+    return diff;
 }
 
-static void from_json(const nlohmann::json &j, LayoutSaver::Layout &layout)
+}
+
+LayoutSaver::Diff LayoutSaver::diffLayouts(const QByteArray &from, const QByteArray &to)
 {
-    layout.serializationVersion = j.value("serializationVersion", 0);
-    layout.mainWindows = j.value("mainWindows", LayoutSaver::MainWindow::List {});
-    layout.allDockWidgets = j.value("allDockWidgets", LayoutSaver::DockWidget::List {});
+    // Only one LayoutSaver::Layout can exist at a time, so summarize one before parsing the other
+    std::unique_ptr<LayoutSummary> fromSummary;
+    {
+        LayoutSaver::Layout layout;
+        if (!layout.fromJson(from))
+            return {};
+        fromSummary = std::make_unique<LayoutSummary>(layout);
+    }
 
-    layout.closedDockWidgets.clear();
+    LayoutSaver::Layout layout;
+    if (!layout.fromJson(to))
+        return {};
 
-    const auto closedDockWidgets = j.value("closedDockWidgets", Vector<QString>());
-    for (const QString &name : closedDockWidgets) {
-        layout.closedDockWidgets.push_back(
-            LayoutSaver::DockWidget::dockWidgetForName(name));
+    return diffSummaries(*fromSummary, LayoutSummary(layout));
+}
+
+LayoutSaver::Diff LayoutSaver::diffWithCurrentLayout(const QByteArray &serialized) const
+{
+    std::unique_ptr<LayoutSummary> current;
+    {
+        LayoutSaver::Layout layout;
+        if (!d->serializeTo(layout))
+            return {};
+        current = std::make_unique<LayoutSummary>(layout);
     }
 
-    layout.floatingWindows = j.value("floatingWindows", LayoutSaver::FloatingWindow::List {});
-    layout.screenInfo = j.value("screenInfo", LayoutSaver::ScreenInfo::List {});
+    LayoutSaver::Layout layout;
+    if (!layout.fromJson(serialized))
+        return {};
+
+    return diffSummaries(*current, LayoutSummary(layout));
+}
+
+namespace {
+
+/// Builds a json DOM out of SAX events.
+/// Used to materialize a single element of the layout at a time, instead of the whole document.
+class JsonDomBuilder
+{
+public:
+    void startContainer(nlohmann::json::value_t type)
+    {
+        m_stack.push_back(addValue(nlohmann::json(type)));
+    }
+
+    void endContainer()
+    {
+        m_stack.pop_back();
+    }
+
+    void key(std::string &key)
+    {
+        m_objectElement = &(*m_stack.back())[std::move(key)];
+    }
+
+    nlohmann::json *addValue(nlohmann::json &&value)
+    {
+        if (m_stack.empty()) {
+            m_root = std::move(value);
+            return &m_root;
+        }
+
+        nlohmann::json *parent = m_stack.back();
+        if (parent->is_array()) {
+            parent->push_back(std::move(value));
+            return &parent->back();
+        }
+
+        *m_objectElement = std::move(value);
+        return m_objectElement;
+    }
+
+    /// Returns whether the value being built is complete, i.e. all its containers were closed
+    bool isComplete() const
+    {
+        return m_stack.empty();
+    }
+
+    nlohmann::json take()
+    {
+        return std::move(m_root);
+    }
+
+private:
+    nlohmann::json m_root;
+    std::vector<nlohmann::json *> m_stack;
+    nlohmann::json *m_objectElement = nullptr;
+};
+
+/// Populates a LayoutSaver::Layout directly from SAX events.
+///
+/// The big top-level arrays ("mainWindows", "floatingWindows", "allDockWidgets", etc.) are
+/// streamed: only one of their elements is materialized as json at a time, converted with the
+/// usual from_json() and then discarded. Anything else, including unexpected types, goes through
+/// layoutValueFromJson(), so behaviour matches the DOM based parsing.
+class LayoutSaxHandler : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+    explicit LayoutSaxHandler(LayoutSaver::Layout &layout)
+        : m_layout(layout)
+    {
+    }
+
+    bool null() override
+    {
+        return onValue([this] { m_builder.addValue(nullptr); });
+    }
+
+    bool boolean(bool val) override
+    {
+        return onValue([this, val] { m_builder.addValue(val); });
+    }
+
+    bool number_integer(number_integer_t val) override
+    {
+        return onValue([this, val] { m_builder.addValue(val); });
+    }
+
+    bool number_unsigned(number_unsigned_t val) override
+    {
+        return onValue([this, val] { m_builder.addValue(val); });
+    }
+
+    bool number_float(number_float_t val, const string_t &) override
+    {
+        return onValue([this, val] { m_builder.addValue(val); });
+    }
+
+    bool string(string_t &val) override
+    {
+        return onValue([this, &val] { m_builder.addValue(std::move(val)); });
+    }
+
+    bool binary(binary_t &) override
+    {
+        // Not produced by the json parser
+        return false;
+    }
+
+    bool start_object(std::size_t) override
+    {
+        if (!m_capturing && m_state == State::BeforeRoot) {
+            m_state = State::InRoot;
+            return true;
+        }
+
+        return onValue([this] { m_builder.startContainer(nlohmann::json::value_t::object); });
+    }
+
+    bool key(string_t &val) override
+    {
+        if (m_capturing) {
+            m_builder.key(val);
+        } else {
+            m_currentKey = std::move(val);
+        }
+
+        return true;
+    }
+
+    bool end_object() override
+    {
+        if (!m_capturing) {
+            m_state = State::Done;
+            return true;
+        }
+
+        return onContainerEnd();
+    }
+
+    bool start_array(std::size_t) override
+    {
+        if (!m_capturing && m_state == State::InRoot && beginSection())
+            return true;
+
+        return onValue([this] { m_builder.startContainer(nlohmann::json::value_t::array); });
+    }
+
+    bool end_array() override
+    {
+        if (!m_capturing) {
+            m_state = State::InRoot;
+            return true;
+        }
+
+        return onContainerEnd();
+    }
+
+    bool parse_error(std::size_t, const std::string &, const nlohmann::json::exception &) override
+    {
+        return false;
+    }
+
+    /// The top-level values which weren't streamed. To be passed to layoutValueFromJson()
+    nlohmann::json remainingValues = nlohmann::json::object();
+
+private:
+    enum class State {
+        BeforeRoot,
+        InRoot,
+        InSection,
+        Done
+    };
+
+    template<typename Func>
+    bool onValue(Func addToBuilder)
+    {
+        if (!m_capturing) {
+            if (m_state != State::InRoot && m_state != State::InSection) {
+                // Root isn't an object
+                return false;
+            }
+            m_capturing = true;
+        }
+
+        addToBuilder();
+        return m_builder.isComplete() ? finishCapture() : true;
+    }
+
+    bool onContainerEnd()
+    {
+        m_builder.endContainer();
+        return m_builder.isComplete() ? finishCapture() : true;
+    }
+
+    /// Called when an array starts as the value of a top-level key.
+    /// Returns true if that array will be streamed.
+    bool beginSection()
+    {
+        if (m_currentKey == "mainWindows") {
+            m_layout.mainWindows.clear();
+        } else if (m_currentKey == "floatingWindows") {
+            m_layout.floatingWindows.clear();
+        } else if (m_currentKey == "allDockWidgets") {
+            m_layout.allDockWidgets.clear();
+        } else if (m_currentKey == "closedDockWidgets") {
+            m_layout.closedDockWidgets.clear();
+        } else if (m_currentKey == "screenInfo") {
+            m_layout.screenInfo.clear();
+        } else {
+            return false;
+        }
+
+        m_state = State::InSection;
+        return true;
+    }
+
+    bool finishCapture()
+    {
+        m_capturing = false;
+        nlohmann::json value = m_builder.take();
+
+        if (m_state == State::InRoot) {
+            remainingValues[m_currentKey] = std::move(value);
+            return true;
+        }
+
+        // An element of a streamed array
+        if (m_currentKey == "mainWindows") {
+            m_layout.mainWindows.push_back(value.get<LayoutSaver::MainWindow>());
+        } else if (m_currentKey == "floatingWindows") {
+            m_layout.floatingWindows.push_back(value.get<LayoutSaver::FloatingWindow>());
+        } else if (m_currentKey == "allDockWidgets") {
+            if (auto dw = dockWidgetFromJson(value))
+                m_layout.allDockWidgets.push_back(dw);
+        } else if (m_currentKey == "closedDockWidgets") {
+            m_layout.closedDockWidgets.push_back(
+                LayoutSaver::DockWidget::dockWidgetForName(value.get<QString>()));
+        } else if (m_currentKey == "screenInfo") {
+            m_layout.screenInfo.push_back(value.get<LayoutSaver::ScreenInfo>());
+        }
+
+        return true;
+    }
+
+    LayoutSaver::Layout &m_layout;
+    JsonDomBuilder m_builder;
+    std::string m_currentKey;
+    State m_state = State::BeforeRoot;
+    bool m_capturing = false;
+};
+
+/// Appends @p value as nlohmann::json::dump(4) would if it were nested @p indent spaces deep
+void writeJson(std::string &out, const nlohmann::json &value, int indent)
+{
+    const std::string dumped = value.dump(4);
+    for (char c : dumped) {
+        out += c;
+        if (c == '\n')
+            out.append(size_t(indent), ' ');
+    }
+}
+
+/// Appends @p list as a json array, converting one element at a time, so the whole layout never
+/// needs to exist as json in memory.
+template<typename List, typename ToJson>
+void writeJsonArray(std::string &out, const List &list, ToJson toJson)
+{
+    if (list.isEmpty()) {
+        // Can be either null or [], depending on the type's to_json()
+        writeJson(out, nlohmann::json(list), 4);
+        return;
+    }
+
+    bool isFirst = true;
+    for (const auto &element : list) {
+        out += isFirst ? "[\n" : ",\n";
+        out.append(8, ' ');
+        writeJson(out, toJson(element), 8);
+        isFirst = false;
+    }
+    out += "\n    ]";
+}
+
+void writeJsonKey(std::string &out, const char *key)
+{
+    out += "    \"";
+    out += key;
+    out += "\": ";
+}
+
+}
+
+namespace KDDockWidgets {
+/// Converts a top-level value of the layout which wasn't streamed by LayoutSaxHandler
+static void layoutValueFromJson(const std::string &key, const nlohmann::json &value,
+                                LayoutSaver::Layout &layout)
+{
+    if (key == "serializationVersion") {
+        layout.serializationVersion = value.get<int>();
+    } else if (key == "mainWindows") {
+        layout.mainWindows = value.get<LayoutSaver::MainWindow::List>();
+    } else if (key == "allDockWidgets") {
+        layout.allDockWidgets = value.get<LayoutSaver::DockWidget::List>();
+    } else if (key == "closedDockWidgets") {
+        layout.closedDockWidgets.clear();
+        const auto closedDockWidgets = value.get<Vector<QString>>();
+        for (const QString &name : closedDockWidgets) {
+            layout.closedDockWidgets.push_back(
+                LayoutSaver::DockWidget::dockWidgetForName(name));
+        }
+    } else if (key == "floatingWindows") {
+        layout.floatingWindows = value.get<LayoutSaver::FloatingWindow::List>();
+    } else if (key == "screenInfo") {
+        layout.screenInfo = value.get<LayoutSaver::ScreenInfo::List>();
+    }
 }
 }
 
 QByteArray LayoutSaver::Layout::toJson() const
 {
-    nlohmann::json json = *this;
-    return QByteArray::fromStdString(json.dump(4));
+    // Equivalent to nlohmann::json::dump(4) of the whole layout, keys sorted alphabetically,
+    // but without building the json DOM for it
+    std::string out = "{\n";
+
+    writeJsonKey(out, "allDockWidgets");
+    writeJsonArray(out, allDockWidgets, [](const LayoutSaver::DockWidget::Ptr &dw) { return nlohmann::json(*dw); });
+    out += ",\n";
+
+    writeJsonKey(out, "closedDockWidgets");
+    writeJson(out, ::dockWidgetNames(closedDockWidgets), 4);
+    out += ",\n";
+
+    writeJsonKey(out, "floatingWindows");
+    writeJsonArray(out, floatingWindows, [](const LayoutSaver::FloatingWindow &fw) { return nlohmann::json(fw); });
+    out += ",\n";
+
+    writeJsonKey(out, "mainWindows");
+    writeJsonArray(out, mainWindows, [](const LayoutSaver::MainWindow &mw) { return nlohmann::json(mw); });
+    out += ",\n";
+
+    writeJsonKey(out, "screenInfo");
+    writeJsonArray(out, screenInfo, [](const LayoutSaver::ScreenInfo &info) { return nlohmann::json(info); });
+    out += ",\n";
+
+    writeJsonKey(out, "serializationVersion");
+    writeJson(out, serializationVersion, 4);
+    out += "\n}";
+
+    return QByteArray::fromStdString(out);
 }
 
 bool LayoutSaver::Layout::fromJson(const QByteArray &jsonData)
 {
-    nlohmann::json json = nlohmann::json::parse(jsonData, nullptr, /*allow_exceptions=*/false);
-    if (json.is_discarded()) {
-        return false;
-    }
+    // Same defaults as when the keys are missing
+    serializationVersion = 0;
+    mainWindows.clear();
+    floatingWindows.clear();
+    closedDockWidgets.clear();
+    allDockWidgets.clear();
+    screenInfo.clear();
 
     try {
-        from_json(json, *this);
+        LayoutSaxHandler handler(*this);
+        if (!nlohmann::json::sax_parse(jsonData.constData(), jsonData.constData() + jsonData.size(), &handler))
+            return false;
+
+        for (const auto &it : handler.remainingValues.items())
+            layoutValueFromJson(it.key(), it.value(), *this);
     } catch (const std::exception &e) {
         KDDW_ERROR("LayoutSaver::Layout::fromJson: Caught exception: {}", e.what());
         return false;
@@ -1100,6 +1650,13 @@ void LayoutSaver::DockWidget::scaleSizes(const ScalingInfo &scalingInfo)
     lastPosition.scaleSizes(scalingInfo);
 }
 
+QByteArray LayoutSaver::DockWidget::toJson() const
+{
+    nlohmann::json json;
+    to_json(json, *this);
+    return QByteArray::fromStdString(json.dump());
+}
+
 bool LayoutSaver::DockWidget::skipsRestore() const
 {
     if (Core::DockWidget *dw = DockRegistry::self()->dockByName(uniqueName))
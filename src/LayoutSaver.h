@@ -129,6 +129,63 @@ public:
     static Vector<QString> sideBarDockWidgetsInLayout(const QString &jsonFilename);
     static Vector<QString> sideBarDockWidgetsInLayout(const QByteArray &serialized);
 
+    /// @brief What changed between two layouts. See diffLayouts()
+    /// Dock widget lists are sorted by name.
+    struct Diff
+    {
+        /// Open in the new layout, but not in the old one
+        Vector<QString> openedDockWidgets;
+
+        /// Open in the old layout, but not in the new one
+        Vector<QString> closedDockWidgets;
+
+        /// Now in another window or side bar, tabbed differently, or at another position
+        Vector<QString> movedDockWidgets;
+
+        /// At the same position, but with a different size
+        Vector<QString> resizedDockWidgets;
+
+        /// Not moved, but became the current tab of their group
+        Vector<QString> newCurrentTabs;
+
+        /// Main windows with a different geometry, window state or visibility
+        Vector<QString> changedMainWindows;
+
+        /// Floating windows with a different geometry, window state or visibility.
+        /// Each one is identified by the names of its dock widgets.
+        Vector<Vector<QString>> changedFloatingWindows;
+
+        /// false if one of the layouts couldn't be parsed
+        bool isValid = false;
+
+        /// Returns whether both layouts are valid and equivalent, in which case restoring one over
+        /// the other is a no-op
+        bool isEmpty() const
+        {
+            return isValid && openedDockWidgets.isEmpty() && closedDockWidgets.isEmpty()
+                && movedDockWidgets.isEmpty() && resizedDockWidgets.isEmpty()
+                && newCurrentTabs.isEmpty() && changedMainWindows.isEmpty()
+                && changedFloatingWindows.isEmpty();
+        }
+    };
+
+    /**
+     * @brief Compares two layouts, as returned by serializeLayout()
+     *
+     * Only the json is looked at, no window or dock widget is created or touched.
+     * Useful to skip restoring a layout which is already applied, or saving the same layout twice.
+     */
+    static Diff diffLayouts(const QByteArray &from, const QByteArray &to);
+
+    /**
+     * @brief Compares the current layout against @p serialized
+     *
+     * The diff describes what restoring @p serialized would change. Honours setAffinityNames().
+     * Same as diffLayouts(serializeLayout(), serialized), but the current layout doesn't go
+     * through json.
+     */
+    Diff diffWithCurrentLayout(const QByteArray &serialized) const;
+
     /// @internal Returns the private-impl. Not intended for public use.
     class Private;
     Private *dptr() const;
@@ -0,0 +1,127 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "kddockwidgets/Tracing.h"
+#include "core/Logging_p.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+using namespace KDDockWidgets;
+
+namespace {
+std::atomic<TraceSink *> s_currentSink { nullptr };
+}
+
+TraceSink::~TraceSink()
+{
+    if (s_currentSink.load() == this) {
+        KDDW_ERROR("TraceSink::~TraceSink: Sink destroyed while still set as current");
+        s_currentSink = nullptr;
+    }
+}
+
+void TraceSink::setCurrent(TraceSink *sink)
+{
+    s_currentSink = sink;
+}
+
+TraceSink *TraceSink::current()
+{
+    return s_currentSink.load(std::memory_order_relaxed);
+}
+
+bool TraceSink::isCompiledIn()
+{
+#ifdef KDDW_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+class ChromeTraceFileSink::Private
+{
+public:
+    explicit Private(const QString &filename)
+        : m_filename(filename)
+    {
+    }
+
+    const QString m_filename;
+    mutable std::mutex m_mutex;
+    std::vector<TraceEvent> m_events;
+};
+
+ChromeTraceFileSink::ChromeTraceFileSink(const QString &filename)
+    : d(new Private(filename))
+{
+}
+
+ChromeTraceFileSink::~ChromeTraceFileSink()
+{
+    flush();
+    delete d;
+}
+
+void ChromeTraceFileSink::addEvent(const TraceEvent &event)
+{
+    std::lock_guard<std::mutex> lock(d->m_mutex);
+    d->m_events.push_back(event);
+}
+
+int ChromeTraceFileSink::numEvents() const
+{
+    std::lock_guard<std::mutex> lock(d->m_mutex);
+    return int(d->m_events.size());
+}
+
+bool ChromeTraceFileSink::flush()
+{
+    // See the "Trace Event Format" document, by the Chromium project
+    nlohmann::json events = nlohmann::json::array();
+    {
+        std::lock_guard<std::mutex> lock(d->m_mutex);
+        for (const TraceEvent &event : d->m_events) {
+            nlohmann::json json;
+            json["name"] = event.name ? event.name : "";
+            json["cat"] = event.category ? event.category : "";
+            json["ts"] = event.timestampUs;
+            json["pid"] = 1;
+            json["tid"] = event.threadId;
+            if (event.isInstant()) {
+                json["ph"] = "i";
+                json["s"] = "t";
+            } else {
+                json["ph"] = "X";
+                json["dur"] = event.durationUs;
+            }
+            events.push_back(std::move(json));
+        }
+    }
+
+    nlohmann::json root;
+    root["traceEvents"] = std::move(events);
+    root["displayTimeUnit"] = "ms";
+
+    std::ofstream file(d->m_filename.toStdString(), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        KDDW_ERROR("ChromeTraceFileSink::flush: Failed to open {}", d->m_filename);
+        return false;
+    }
+
+    file << root.dump();
+    return file.good();
+}
@@ -0,0 +1,127 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#ifndef KD_TRACING_H
+#define KD_TRACING_H
+
+/**
+ * @file
+ * @brief Opt-in trace events, to profile docking operations in a timeline
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#include "kddockwidgets/docks_export.h"
+
+#include "kddockwidgets/KDDockWidgets.h"
+
+#include <cstdint>
+
+namespace KDDockWidgets {
+
+/**
+ * @brief A single trace event, as passed to TraceSink::addEvent()
+ */
+struct TraceEvent
+{
+    /// @brief The operation, for example "DropArea::drop". Points to a string literal.
+    const char *name = nullptr;
+
+    /// @brief The category, for example "layouting". Points to a string literal.
+    const char *category = nullptr;
+
+    /// @brief When the operation started, in microseconds of a monotonic clock
+    int64_t timestampUs = 0;
+
+    /// @brief How long the operation took, in microseconds. -1 for instant events, such as
+    /// drag state transitions.
+    int64_t durationUs = -1;
+
+    /// @brief The thread the operation ran on
+    uint64_t threadId = 0;
+
+    bool isInstant() const
+    {
+        return durationUs < 0;
+    }
+};
+
+/**
+ * @brief Receives trace events for the main docking operations
+ *
+ * Trace events are compiled out by default. Build with -DKDDockWidgets_TRACING=ON to get events
+ * for floating, tabbing, dropping, layouting, restoring layouts and drag state transitions.
+ *
+ * Events are only generated while a sink is set. addEvent() is called right after the operation
+ * finished, on the thread it ran on.
+ *
+ * Example:
+ *     ChromeTraceFileSink sink(QStringLiteral("/tmp/kddw.json"));
+ *     TraceSink::setCurrent(&sink);
+ *     // reproduce the slow interaction
+ *     TraceSink::setCurrent(nullptr);
+ *     sink.flush();
+ */
+class DOCKS_EXPORT TraceSink
+{
+public:
+    TraceSink() = default;
+    virtual ~TraceSink();
+
+    ///@brief Called for every trace event. Might be called from any thread.
+    virtual void addEvent(const TraceEvent &) = 0;
+
+    ///@brief Sets the sink receiving the events. nullptr, the default, disables tracing.
+    /// The sink isn't owned and must be unset before being destroyed.
+    static void setCurrent(TraceSink *);
+
+    ///@brief Returns the sink set with setCurrent()
+    static TraceSink *current();
+
+    ///@brief Returns whether KDDockWidgets was built with tracing support
+    /// If false, no events will be generated, regardless of the sink.
+    static bool isCompiledIn();
+
+private:
+    KDDW_DELETE_COPY_CTOR(TraceSink)
+};
+
+/**
+ * @brief A TraceSink which writes the events in Chrome's trace-event JSON format
+ *
+ * The resulting file can be opened with https://ui.perfetto.dev or chrome://tracing.
+ * Events are kept in memory and only written by flush() or the destructor.
+ */
+class DOCKS_EXPORT ChromeTraceFileSink : public TraceSink
+{
+public:
+    explicit ChromeTraceFileSink(const QString &filename);
+
+    ///@brief Destructor. Calls flush().
+    ~ChromeTraceFileSink() override;
+
+    void addEvent(const TraceEvent &) override;
+
+    ///@brief Returns the number of events received so far
+    int numEvents() const;
+
+    ///@brief Writes all events received so far to the file, replacing its contents
+    ///@return true on success
+    bool flush();
+
+private:
+    class Private;
+    Private *const d;
+};
+
+}
+
+#endif
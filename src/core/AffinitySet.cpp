@@ -0,0 +1,179 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "AffinitySet_p.h"
+#include "core/DockWidget_p.h"
+#include "core/MainWindow_p.h"
+#include "core/Group.h"
+#include "core/FloatingWindow.h"
+#include "core/DropArea.h"
+#include "core/WindowBeingDragged_p.h"
+
+#include <algorithm>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+StringTable *StringTable::self()
+{
+    static StringTable table;
+    return &table;
+}
+
+StringTable *StringTable::affinities()
+{
+    static StringTable table;
+    return &table;
+}
+
+int StringTable::intern(const QString &str)
+{
+    auto it = m_ids.find(str);
+    if (it != m_ids.cend())
+        return it->second;
+
+    const int id = int(m_strings.size());
+    m_strings.push_back(str);
+    m_ids.emplace(str, id);
+    return id;
+}
+
+int StringTable::idFor(const QString &str) const
+{
+    auto it = m_ids.find(str);
+    return it == m_ids.cend() ? -1 : it->second;
+}
+
+QString StringTable::stringFor(int id) const
+{
+    if (id < 0 || id >= int(m_strings.size()))
+        return {};
+
+    return m_strings[size_t(id)];
+}
+
+int StringTable::count() const
+{
+    return int(m_strings.size());
+}
+
+AffinitySet::AffinitySet(const Vector<QString> &affinities)
+{
+    // Empty strings are interned too, like DockRegistry::affinitiesMatch() always compared them.
+    // setAffinities() removes them anyway.
+    for (const QString &affinity : affinities)
+        insert(StringTable::affinities()->intern(affinity));
+}
+
+AffinitySet AffinitySet::lookup(const Vector<QString> &affinities)
+{
+    AffinitySet set;
+    for (const QString &affinity : affinities) {
+        const int id = StringTable::affinities()->idFor(affinity);
+        if (id == -1)
+            set.m_hasUnknown = true;
+        else
+            set.insert(id);
+    }
+
+    return set;
+}
+
+const AffinitySet &AffinitySet::emptySet()
+{
+    static const AffinitySet empty;
+    return empty;
+}
+
+void AffinitySet::insert(int id)
+{
+    if (id < 64) {
+        m_bits |= uint64_t(1) << id;
+        return;
+    }
+
+    const auto word = size_t(id / 64) - 1;
+    if (m_extraBits.size() <= word)
+        m_extraBits.resize(word + 1, 0);
+    m_extraBits[word] |= uint64_t(1) << (id % 64);
+}
+
+bool AffinitySet::isEmpty() const
+{
+    // insert() only ever sets bits, so a non-empty m_extraBits always has a bit set
+    return m_bits == 0 && m_extraBits.empty() && !m_hasUnknown;
+}
+
+bool AffinitySet::intersects(const AffinitySet &other) const
+{
+    if (m_bits & other.m_bits)
+        return true;
+
+    const size_t count = std::min(m_extraBits.size(), other.m_extraBits.size());
+    for (size_t i = 0; i < count; ++i) {
+        if (m_extraBits[i] & other.m_extraBits[i])
+            return true;
+    }
+
+    return false;
+}
+
+bool AffinitySet::operator==(const AffinitySet &other) const
+{
+    return m_bits == other.m_bits && m_extraBits == other.m_extraBits
+        && m_hasUnknown == other.m_hasUnknown;
+}
+
+const AffinitySet &Core::affinitySetOf(const Core::DockWidget *dw)
+{
+    return dw ? dw->d->affinitySet : AffinitySet::emptySet();
+}
+
+const AffinitySet &Core::affinitySetOf(const Core::MainWindow *mw)
+{
+    return mw ? mw->d->affinitySet : AffinitySet::emptySet();
+}
+
+const AffinitySet &Core::affinitySetOf(const Core::Group *group)
+{
+    if (!group)
+        return AffinitySet::emptySet();
+
+    if (group->isEmpty())
+        return affinitySetOf(group->mainWindow());
+
+    return affinitySetOf(group->dockWidgetAt(0));
+}
+
+const AffinitySet &Core::affinitySetOf(const Core::FloatingWindow *fw)
+{
+    if (!fw)
+        return AffinitySet::emptySet();
+
+    const auto groups = fw->groups();
+    return groups.isEmpty() ? AffinitySet::emptySet() : affinitySetOf(groups.constFirst());
+}
+
+const AffinitySet &Core::affinitySetOf(const Core::DropArea *dropArea)
+{
+    if (!dropArea)
+        return AffinitySet::emptySet();
+
+    if (auto mw = dropArea->mainWindow())
+        return affinitySetOf(mw);
+
+    return affinitySetOf(dropArea->floatingWindow());
+}
+
+const AffinitySet &Core::affinitySetOf(const Core::WindowBeingDragged *wbd)
+{
+    return wbd ? wbd->affinitySet() : AffinitySet::emptySet();
+}
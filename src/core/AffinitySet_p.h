@@ -0,0 +1,117 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "kddockwidgets/docks_export.h"
+#include "kddockwidgets/QtCompat_p.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace KDDockWidgets::Core {
+
+class DockWidget;
+class MainWindow;
+class Group;
+class FloatingWindow;
+class DropArea;
+struct WindowBeingDragged;
+
+/// Interns strings, such as dock widget names and affinities, into small integer ids.
+/// Comparing or hashing ids is much cheaper than doing it for QString.
+/// Ids are never reused or released, as the set of names an application uses is small and bounded.
+/// Like DockRegistry, it's only meant to be used from the GUI thread.
+class DOCKS_EXPORT_FOR_UNIT_TESTS StringTable
+{
+public:
+    /// The table for dock widget unique names
+    static StringTable *self();
+
+    /// The table for affinities. Separate from the names one, so affinity ids stay small and
+    /// AffinitySet doesn't need to allocate.
+    static StringTable *affinities();
+
+    /// Returns the id for @p str, interning it if needed
+    int intern(const QString &str);
+
+    /// Returns the id for @p str, or -1 if it was never interned.
+    /// Useful for lookups, as a string which was never interned can't be equal to any interned one.
+    int idFor(const QString &str) const;
+
+    /// Returns the string for @p id. Empty if @p id is invalid.
+    QString stringFor(int id) const;
+
+    /// Returns the number of interned strings
+    int count() const;
+
+private:
+    StringTable() = default;
+    std::unordered_map<QString, int> m_ids;
+    std::vector<QString> m_strings;
+};
+
+/// A set of affinities, represented as a bitset of interned affinity names.
+/// Matching two sets is then a bitwise AND instead of comparing strings.
+class DOCKS_EXPORT_FOR_UNIT_TESTS AffinitySet
+{
+public:
+    AffinitySet() = default;
+    explicit AffinitySet(const Vector<QString> &affinities);
+
+    /// Returns a shared empty set, for functions returning by reference
+    static const AffinitySet &emptySet();
+
+    /// Like the constructor, but doesn't intern anything. For matching strings coming from the
+    /// public API against existing affinities, without growing the table. A string which was never
+    /// interned can't intersect with anything, but still makes the set non-empty.
+    static AffinitySet lookup(const Vector<QString> &affinities);
+
+    bool isEmpty() const;
+
+    /// Returns whether both sets have at least one affinity in common
+    bool intersects(const AffinitySet &other) const;
+
+    /// Returns whether two objects with these affinities can be docked together.
+    /// Same semantics as DockRegistry::affinitiesMatch(): Either both are empty or they intersect.
+    bool matches(const AffinitySet &other) const
+    {
+        return (isEmpty() && other.isEmpty()) || intersects(other);
+    }
+
+    bool operator==(const AffinitySet &other) const;
+    bool operator!=(const AffinitySet &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    void insert(int id);
+
+    // Ids below 64 live in the first word, so the common case doesn't allocate
+    uint64_t m_bits = 0;
+    std::vector<uint64_t> m_extraBits;
+
+    // Whether lookup() found affinities which were never interned
+    bool m_hasUnknown = false;
+};
+
+/// Returns the same as the respective affinities() methods, but interned.
+/// These don't copy anything, so they're suitable for hot paths, like hovering while dragging.
+const AffinitySet &affinitySetOf(const Core::DockWidget *);
+const AffinitySet &affinitySetOf(const Core::MainWindow *);
+const AffinitySet &affinitySetOf(const Core::Group *);
+const AffinitySet &affinitySetOf(const Core::FloatingWindow *);
+const AffinitySet &affinitySetOf(const Core::DropArea *);
+const AffinitySet &affinitySetOf(const Core::WindowBeingDragged *);
+
+}
@@ -56,3 +56,19 @@ void DelayedEmitFocusChanged::call()
         m_dockWidget->d->isFocusedChanged.emit(m_focused);
     }
 }
+
+
+DelayedUpdateTitle::DelayedUpdateTitle(DockWidget *dw)
+    : m_dockWidget(dw)
+{
+}
+
+DelayedUpdateTitle::~DelayedUpdateTitle() = default;
+
+void DelayedUpdateTitle::call()
+{
+    if (m_dockWidget) {
+        m_dockWidget->d->m_updateTitleScheduled = false;
+        m_dockWidget->d->updateTitle();
+    }
+}
@@ -56,4 +56,17 @@ private:
     const bool m_focused;
 };
 
+class DelayedUpdateTitle : public DelayedCall
+{
+public:
+    explicit DelayedUpdateTitle(DockWidget *);
+    ~DelayedUpdateTitle() override;
+
+    void call() override;
+
+    KDDW_DELETE_COPY_CTOR(DelayedUpdateTitle)
+private:
+    ObjectGuard<DockWidget> m_dockWidget;
+};
+
 }
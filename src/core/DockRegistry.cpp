@@ -22,9 +22,18 @@
 #include "core/layouting/Item_p.h"
 #include "core/layouting/LayoutingHost_p.h"
 #include "core/DockWidget_p.h"
+#include "core/AffinitySet_p.h"
 #include "core/ObjectGuard_p.h"
 #include "core/views/MainWindowViewInterface.h"
 #include "core/FloatingWindow.h"
+#include "core/FloatingWindow_p.h"
+#include "core/Group_p.h"
+#include "core/LayoutSaver_p.h"
+#include "core/Separator.h"
+#include "core/Stack.h"
+#include "core/TabBar_p.h"
+#include "core/TitleBar_p.h"
+#include "core/DropIndicatorOverlay.h"
 #include "core/SideBar.h"
 #include "core/MainWindow.h"
 #include "core/DockWidget.h"
@@ -34,6 +43,7 @@
 
 #include "kdbindings/signal.h"
 
+#include <algorithm>
 #include <set>
 #include <utility>
 
@@ -67,6 +77,8 @@ DockRegistry::DockRegistry(Core::Object *parent)
 
     d->m_connection = Platform::instance()->d->focusedViewChanged.connect(
         &DockRegistry::onFocusedViewChanged, this);
+    d->m_windowActivatedConnection = Platform::instance()->d->windowActivated.connect(
+        &DockRegistry::onWindowActivated, this);
 }
 
 DockRegistry::~DockRegistry()
@@ -137,6 +149,8 @@ bool DockRegistry::isEmpty(bool excludeBeingDeleted) const
 bool DockRegistry::affinitiesMatch(const QVector<QString> &affinities1,
                                    const QVector<QString> &affinities2) const
 {
+    // Compares strings instead of interning them, as these can be arbitrary strings and the
+    // table never shrinks. Both vectors are usually tiny.
     if (affinities1.isEmpty() && affinities2.isEmpty())
         return true;
 
@@ -177,28 +191,27 @@ bool DockRegistry::isProbablyObscured(Core::Window::Ptr window,
         return false;
 
     const Rect geo = window->geometry();
-    for (Core::FloatingWindow *fw : m_floatingWindows) {
-        Window::Ptr fwWindow = fw->view()->window();
-        if (fw == exclude || fwWindow->equals(window))
-            continue;
-
-        if (fwWindow->geometry().intersects(geo)) {
-            // fw might be below, but we don't have a way to check. So be conservative and return
-            // true.
-            return true;
-        }
-    }
 
     // Floating windows are Tool (keep above), unless we disabled it in Config
     auto fw = floatingWindowForHandle(window);
     const bool targetIsToolWindow =
         fw && fw->isUtilityWindow();
 
-    for (Core::MainWindow *mw : m_mainWindows) {
-        Window::Ptr mwWindow = mw->view()->window();
+    for (const Private::TopLevel &tl : d->m_zOrder) {
+        Window::Ptr tlWindow = d->m_topLevelGeometriesFrozen ? tl.window : tl.controller->view()->window();
+        if (!tlWindow || tlWindow->equals(window))
+            continue;
 
-        if (mwWindow && !mwWindow->equals(window) && !targetIsToolWindow
-            && mwWindow->geometry().intersects(geo)) {
+        const Rect tlGeometry = d->m_topLevelGeometriesFrozen ? tl.geometry : tlWindow->geometry();
+        if (!tlGeometry.intersects(geo))
+            continue;
+
+        if (tl.controller->is(ViewType::FloatingWindow)) {
+            // fw might be below, but we don't have a way to check. So be conservative and return
+            // true.
+            if (tl.controller != exclude)
+                return true;
+        } else if (!targetIsToolWindow) {
             // Two main windows that intersect. Return true. If the target is a tool window it will
             // be above, so we don't care.
             return true;
@@ -217,6 +230,123 @@ bool DockRegistry::isProbablyObscured(Core::Window::Ptr target, WindowBeingDragg
     return isProbablyObscured(target, fw);
 }
 
+namespace {
+
+size_t stringBytes(const QString &str)
+{
+    return sizeof(QString) + size_t(str.capacity()) * sizeof(QString::value_type);
+}
+
+void addItemsMemoryUsage(const Item *item, DockRegistry::MemoryUsage::LayoutUsage &usage)
+{
+    if (const ItemContainer *container = item->asContainer()) {
+        usage.items.add(sizeof(ItemBoxContainer));
+        const Item::List children = container->childItems();
+        for (const Item *child : children)
+            addItemsMemoryUsage(child, usage);
+    } else if (item->isPlaceholder()) {
+        usage.placeholderItems.add(sizeof(Item));
+    } else {
+        usage.items.add(sizeof(Item));
+    }
+}
+
+DockRegistry::MemoryUsage::LayoutUsage layoutMemoryUsage(Core::Layout *layout)
+{
+    DockRegistry::MemoryUsage::LayoutUsage usage;
+    if (!layout)
+        return usage;
+
+    if (ItemContainer *root = layout->rootItem()) {
+        addItemsMemoryUsage(root, usage);
+        if (ItemBoxContainer *box = root->asBoxContainer()) {
+            const auto separators = box->separators_recursive();
+            usage.separators.add(size_t(separators.size()) * sizeof(Core::Separator),
+                                 int(separators.size()));
+        }
+    }
+
+    const auto groups = layout->groups();
+    for (Core::Group *group : groups) {
+        usage.groups.add(sizeof(Core::Group) + sizeof(Core::Group::Private) + sizeof(Core::Stack));
+        if (group->titleBar())
+            usage.titleBars.add(sizeof(Core::TitleBar) + sizeof(Core::TitleBar::Private));
+        if (group->tabBar())
+            usage.tabBars.add(sizeof(Core::TabBar) + sizeof(Core::TabBar::Private));
+    }
+
+    return usage;
+}
+
+}
+
+size_t DockRegistry::MemoryUsage::LayoutUsage::totalBytes() const
+{
+    return items.bytes + placeholderItems.bytes + separators.bytes + groups.bytes + titleBars.bytes
+        + tabBars.bytes;
+}
+
+size_t DockRegistry::MemoryUsage::totalBytes() const
+{
+    size_t total = floatingWindows.bytes + dropIndicatorOverlays.bytes + positions.bytes
+        + savedDockWidgets.bytes + dockWidgetIdRemappings.bytes;
+    for (const LayoutUsage &layout : layouts)
+        total += layout.totalBytes();
+
+    return total;
+}
+
+DockRegistry::MemoryUsage DockRegistry::memoryUsage() const
+{
+    MemoryUsage usage;
+    usage.layouts.reserve(m_mainWindows.size() + m_floatingWindows.size());
+
+    auto addOverlay = [&usage](Core::DropArea *dropArea) {
+        if (dropArea && dropArea->hasDropIndicatorOverlay())
+            usage.dropIndicatorOverlays.add(sizeof(Core::DropIndicatorOverlay));
+    };
+
+    for (Core::MainWindow *mw : m_mainWindows) {
+        MemoryUsage::LayoutUsage layoutUsage = layoutMemoryUsage(mw->layout());
+        layoutUsage.mainWindowName = mw->uniqueName();
+        usage.layouts.push_back(layoutUsage);
+        addOverlay(mw->dropArea());
+    }
+
+    for (Core::FloatingWindow *fw : m_floatingWindows) {
+        usage.floatingWindows.add(sizeof(Core::FloatingWindow) + sizeof(Core::FloatingWindow::Private));
+
+        MemoryUsage::LayoutUsage layoutUsage = layoutMemoryUsage(fw->layout());
+        if (fw->titleBar())
+            layoutUsage.titleBars.add(sizeof(Core::TitleBar) + sizeof(Core::TitleBar::Private));
+        usage.layouts.push_back(layoutUsage);
+        addOverlay(fw->dropArea());
+    }
+
+    for (Core::DockWidget *dw : m_dockWidgets) {
+        if (const Positions::Ptr &positions = dw->d->lastPosition())
+            usage.positions.add(positions->estimatedBytes(), positions->placeholderCount());
+    }
+
+    for (const auto &it : LayoutSaver::Private::s_unrestoredPositions) {
+        if (it.second)
+            usage.positions.add(stringBytes(it.first) + it.second->estimatedBytes(),
+                                it.second->placeholderCount());
+    }
+
+    for (const auto &it : LayoutSaver::DockWidget::s_dockWidgets) {
+        if (it.second)
+            usage.savedDockWidgets.add(sizeof(LayoutSaver::DockWidget) + stringBytes(it.second->uniqueName));
+    }
+
+    // A std::map node has 3 pointers and a color besides the key and value
+    const size_t mapNodeOverhead = 4 * sizeof(void *);
+    for (const auto &it : m_dockWidgetIdRemapping)
+        usage.dockWidgetIdRemappings.add(mapNodeOverhead + stringBytes(it.first) + stringBytes(it.second));
+
+    return usage;
+}
+
 SideBarLocation DockRegistry::sideBarLocationForDockWidget(const Core::DockWidget *dw) const
 {
     if (Core::SideBar *sb = sideBarForDockWidget(dw))
@@ -275,9 +405,9 @@ DockRegistry::mainWindowsWithAffinity(const QVector<QString> &affinities) const
     Core::MainWindow::List result;
     result.reserve(m_mainWindows.size());
 
+    const AffinitySet affinitySet = AffinitySet::lookup(affinities);
     for (auto mw : m_mainWindows) {
-        const QVector<QString> mwAffinities = mw->affinities();
-        if (affinitiesMatch(mwAffinities, affinities))
+        if (affinitySetOf(mw).matches(affinitySet))
             result.push_back(mw);
     }
 
@@ -350,12 +480,14 @@ void DockRegistry::registerMainWindow(Core::MainWindow *mainWindow)
     }
 
     m_mainWindows.push_back(mainWindow);
+    raiseInZOrder(mainWindow);
     Platform::instance()->onMainWindowCreated(mainWindow);
 }
 
 void DockRegistry::unregisterMainWindow(Core::MainWindow *mainWindow)
 {
     m_mainWindows.removeOne(mainWindow);
+    removeFromZOrder(mainWindow);
     Platform::instance()->onMainWindowDestroyed(mainWindow);
     maybeDelete();
 }
@@ -363,12 +495,14 @@ void DockRegistry::unregisterMainWindow(Core::MainWindow *mainWindow)
 void DockRegistry::registerFloatingWindow(Core::FloatingWindow *fw)
 {
     m_floatingWindows.push_back(fw);
+    raiseInZOrder(fw);
     Platform::instance()->onFloatingWindowCreated(fw);
 }
 
 void DockRegistry::unregisterFloatingWindow(Core::FloatingWindow *fw)
 {
     m_floatingWindows.removeOne(fw);
+    removeFromZOrder(fw);
     Platform::instance()->onFloatingWindowDestroyed(fw);
     maybeDelete();
 }
@@ -412,9 +546,14 @@ bool DockRegistry::containsMainWindow(const QString &uniqueName) const
 
 Core::DockWidget *DockRegistry::dockByName(const QString &name, DockByNameFlags flags) const
 {
-    for (auto dock : std::as_const(m_dockWidgets)) {
-        if (dock->uniqueName() == name)
-            return dock;
+    // Compare interned ids instead of strings. A name which was never interned can't belong to
+    // any dock widget.
+    const int nameId = StringTable::self()->idFor(name);
+    if (nameId != -1) {
+        for (auto dock : std::as_const(m_dockWidgets)) {
+            if (dock->d->uniqueNameId() == nameId)
+                return dock;
+        }
     }
 
     if (flags.testFlag(DockByNameFlag::ConsultRemapping)) {
@@ -674,15 +813,16 @@ void DockRegistry::clear(const Core::DockWidget::List &dockWidgets,
                          const Core::MainWindow::List &mainWindows,
                          const QVector<QString> &affinities)
 {
+    const AffinitySet affinitySet = AffinitySet::lookup(affinities);
     for (auto dw : std::as_const(dockWidgets)) {
-        if (affinities.isEmpty() || affinitiesMatch(affinities, dw->affinities())) {
+        if (affinitySet.isEmpty() || affinitySet.matches(affinitySetOf(dw))) {
             dw->forceClose();
             dw->d->lastPosition()->removePlaceholders();
         }
     }
 
     for (auto mw : std::as_const(mainWindows)) {
-        if (affinities.isEmpty() || affinitiesMatch(affinities, mw->affinities())) {
+        if (affinitySet.isEmpty() || affinitySet.matches(affinitySetOf(mw))) {
             mw->layout()->clearLayout();
         }
     }
@@ -772,17 +912,122 @@ bool DockRegistry::onDockWidgetPressed(Core::DockWidget *dw, MouseEvent *ev)
     return false;
 }
 
+int DockRegistry::eventInterests() const
+{
+    return EventInterest_Expose | EventInterest_MouseButtonPress;
+}
+
 bool DockRegistry::onExposeEvent(Core::Window::Ptr window)
 {
     if (Core::FloatingWindow *fw = floatingWindowForHandle(window)) {
         // This floating window was exposed
         m_floatingWindows.removeOne(fw);
         m_floatingWindows.append(fw);
+        raiseInZOrder(fw);
     }
 
     return false;
 }
 
+void DockRegistry::onWindowActivated(std::shared_ptr<View> rootView)
+{
+    Window::Ptr window = rootView ? rootView->window() : nullptr;
+    if (!window)
+        return;
+
+    if (Core::FloatingWindow *fw = floatingWindowForHandle(window)) {
+        raiseInZOrder(fw);
+    } else if (Core::MainWindow *mw = mainWindowForHandle(window)) {
+        raiseInZOrder(mw);
+    }
+}
+
+void DockRegistry::raiseInZOrder(Core::Controller *controller)
+{
+    auto &zOrder = d->m_zOrder;
+    auto it = std::find_if(zOrder.begin(), zOrder.end(), [controller](const Private::TopLevel &tl) {
+        return tl.controller == controller;
+    });
+
+    Private::TopLevel topLevel;
+    if (it == zOrder.end()) {
+        topLevel.controller = controller;
+        if (d->m_topLevelGeometriesFrozen)
+            topLevel.cacheGeometry();
+    } else {
+        topLevel = std::move(*it);
+        zOrder.erase(it);
+    }
+
+    auto pos = zOrder.end();
+    if (!controller->is(ViewType::FloatingWindow)) {
+        // Main windows go below the floating windows
+        pos = std::find_if(zOrder.begin(), zOrder.end(), [](const Private::TopLevel &tl) {
+            return tl.controller->is(ViewType::FloatingWindow);
+        });
+    }
+
+    zOrder.insert(pos, std::move(topLevel));
+}
+
+void DockRegistry::removeFromZOrder(Core::Controller *controller)
+{
+    auto &zOrder = d->m_zOrder;
+    zOrder.erase(std::remove_if(zOrder.begin(), zOrder.end(),
+                                [controller](const Private::TopLevel &tl) {
+                                    return tl.controller == controller;
+                                }),
+                 zOrder.end());
+}
+
+std::shared_ptr<View> DockRegistry::topLevelAt(Point globalPos, View *exclude) const
+{
+    const bool frozen = d->m_topLevelGeometriesFrozen;
+    Window::Ptr excludeWindow = exclude ? exclude->window() : nullptr;
+
+    for (auto it = d->m_zOrder.crbegin(); it != d->m_zOrder.crend(); ++it) {
+        const Private::TopLevel &topLevel = *it;
+        if (!topLevel.controller->isVisible())
+            continue;
+
+        Window::Ptr window = frozen ? topLevel.window : topLevel.controller->view()->window();
+        if (!window || (excludeWindow && excludeWindow->equals(window)))
+            continue;
+
+        const Rect geometry = frozen ? topLevel.geometry : window->geometry();
+        if (!geometry.contains(globalPos))
+            continue;
+
+        auto rootView = frozen ? topLevel.rootView : window->rootView();
+        if (!rootView || rootView->equals(exclude) || rootView->isMinimized())
+            continue;
+
+        return rootView;
+    }
+
+    return nullptr;
+}
+
+void DockRegistry::setTopLevelGeometriesFrozen(bool frozen)
+{
+    d->m_topLevelGeometriesFrozen = frozen;
+    for (Private::TopLevel &topLevel : d->m_zOrder) {
+        if (frozen) {
+            topLevel.cacheGeometry();
+        } else {
+            topLevel.window.reset();
+            topLevel.rootView.reset();
+        }
+    }
+}
+
+void DockRegistry::Private::TopLevel::cacheGeometry()
+{
+    window = controller->view()->window();
+    rootView = window ? window->rootView() : nullptr;
+    geometry = window ? window->geometry() : Rect();
+}
+
 void DockRegistry::addSideBarGrouping(const DockWidget::List &dws)
 {
     m_sideBarGroupings->addGrouping(dws);
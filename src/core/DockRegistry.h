@@ -217,6 +217,66 @@ public:
     /// @overload
     bool isProbablyObscured(std::shared_ptr<Core::Window> target, Core::WindowBeingDragged *exclude) const;
 
+    /// @brief Returns the top-most visible floating window or main window under @p globalPos
+    /// The z-order is tracked from expose and activation events, so this doesn't need to rebuild
+    /// any window list. It's only as good as those events though, see qtTopLevelUnderCursor().
+    /// Note that only the QtWidgets frontend reports window activation.
+    /// @param exclude Root view to skip, usually the window being dragged
+    /// @return the root view of the window, or nullptr if none
+    std::shared_ptr<Core::View> topLevelAt(Point globalPos, Core::View *exclude = nullptr) const;
+
+    /// @brief Caches the geometry of all top-levels, used by topLevelAt() and isProbablyObscured()
+    /// Only done while dragging, as windows other than the dragged one won't move meanwhile.
+    /// Passing false goes back to asking the windows directly.
+    void setTopLevelGeometriesFrozen(bool);
+
+    /// @brief Counts and estimated bytes of the objects the docking framework allocates itself
+    /// Estimates use the size of the controllers and their bookkeeping, not of the views nor of
+    /// what's inside the dock widgets. See memoryUsage().
+    struct MemoryUsage
+    {
+        /// How many objects of one kind there are, and roughly how many bytes they use
+        struct Entry
+        {
+            int count = 0;
+            size_t bytes = 0;
+
+            void add(size_t objectBytes, int n = 1)
+            {
+                count += n;
+                bytes += objectBytes;
+            }
+        };
+
+        /// What the layout of a single main window or floating window costs
+        struct LayoutUsage
+        {
+            /// The main window's unique name. Empty for floating windows.
+            QString mainWindowName;
+            Entry items; ///< Items with a dock widget, and the containers
+            Entry placeholderItems; ///< Items left behind by closed or floated dock widgets
+            Entry separators;
+            Entry groups;
+            Entry titleBars;
+            Entry tabBars;
+
+            size_t totalBytes() const;
+        };
+
+        QVector<LayoutUsage> layouts;
+        Entry floatingWindows;
+        Entry dropIndicatorOverlays;
+        Entry positions; ///< Placeholders memorized by dock widgets, so they can be restored
+        Entry savedDockWidgets; ///< LayoutSaver's dock widget cache, kept after a save or restore
+        Entry dockWidgetIdRemappings;
+
+        size_t totalBytes() const;
+    };
+
+    /// @brief Returns what the docking framework costs in memory, broken down per layout
+    /// Useful to look for leaks in long running sessions.
+    MemoryUsage memoryUsage() const;
+
     ///@brief Returns whether the specified dock widget is in a side bar, and which.
     /// SideBarLocation::None is returned if it's not in a sidebar.
     /// This is only relevant when using the auto-hide and side-bar feature.
@@ -247,9 +307,16 @@ private:
     void setFocusedDockWidget(Core::DockWidget *);
 
     // EventFilterInterface:
+    int eventInterests() const override;
     bool onExposeEvent(std::shared_ptr<Core::Window>) override;
     bool onMouseButtonPress(Core::View *, MouseEvent *) override;
 
+    void onWindowActivated(std::shared_ptr<Core::View> rootView);
+
+    /// Moves a floating window or main window to the top of the tracked z-order
+    void raiseInZOrder(Core::Controller *);
+    void removeFromZOrder(Core::Controller *);
+
     // To honour Config::Flag_AutoHideAsTabGroups:
     void addSideBarGrouping(const QVector<Core::DockWidget *> &);
     void removeSideBarGrouping(const QVector<Core::DockWidget *> &);
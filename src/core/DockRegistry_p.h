@@ -14,6 +14,8 @@
 
 #include <kdbindings/signal.h>
 
+#include <vector>
+
 
 #pragma once
 
@@ -36,7 +38,32 @@ public:
     /// @param inhibited
     KDBindings::Signal<bool> dropIndicatorsInhibitedChanged;
 
+    /// @brief emitted when a layout changes in a way which is interesting to save:
+    /// items inserted or removed, or a separator moved.
+    /// @param layout The layout which changed, or nullptr if a dock widget was floated or closed.
+    /// Used by LayoutAutoSaver. Don't dereference it, it might be being destroyed.
+    KDBindings::Signal<Core::Layout *> layoutChanged;
+
     KDBindings::ConnectionHandle m_connection;
+    KDBindings::ScopedConnection m_windowActivatedConnection;
+
+    /// A floating window or main window, as tracked in m_zOrder
+    struct TopLevel
+    {
+        Core::Controller *controller = nullptr;
+
+        // Only set while geometries are frozen
+        std::shared_ptr<Core::Window> window;
+        std::shared_ptr<Core::View> rootView;
+        Rect geometry;
+
+        void cacheGeometry();
+    };
+
+    /// Top-levels sorted by z-order, bottom-most first. Floating windows are always after main
+    /// windows, as they're kept above them.
+    std::vector<TopLevel> m_zOrder;
+    bool m_topLevelGeometriesFrozen = false;
 
     int m_numLayoutSavers = 0;
 
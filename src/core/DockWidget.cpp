@@ -12,6 +12,7 @@
 #include "DockWidget.h"
 #include "DockWidget_p.h"
 #include "DockRegistry.h"
+#include "DockRegistry_p.h"
 #include "core/LayoutSaver_p.h"
 #include "core/Logging_p.h"
 #include "core/MDILayout.h"
@@ -37,6 +38,7 @@
 #include "Config.h"
 #include "core/ViewFactory.h"
 #include "core/ScopedValueRollback_p.h"
+#include "core/Tracing_p.h"
 
 #ifdef KDDW_FRONTEND_QT
 #include <QTimer>
@@ -102,7 +104,7 @@ void DockWidget::addDockWidgetAsTab(DockWidget *other, const InitialOption &opti
         return;
     }
 
-    if (!DockRegistry::self()->affinitiesMatch(other->affinities(), d->affinities)) {
+    if (!d->affinitySet.matches(other->d->affinitySet)) {
         KDDW_ERROR("Refusing to dock widget with incompatible affinity. {} {}", other->affinities(), affinities());
         return;
     }
@@ -158,7 +160,7 @@ void DockWidget::addDockWidgetToContainingWindow(DockWidget *other, Location loc
         return;
     }
 
-    if (!DockRegistry::self()->affinitiesMatch(other->affinities(), d->affinities)) {
+    if (!d->affinitySet.matches(other->d->affinitySet)) {
         KDDW_ERROR("Refusing to dock widget with incompatible affinity. {} {}", other->affinities(), affinities());
         return;
     }
@@ -218,6 +220,7 @@ bool DockWidget::isFloating() const
 
 bool DockWidget::setFloating(bool floats)
 {
+    KDDW_SCOPED_TRACE("docking", "DockWidget::setFloating");
     const bool alreadyFloating = isFloating();
 
     if (floats == alreadyFloating)
@@ -299,7 +302,10 @@ void DockWidget::setTitle(const QString &title)
 {
     if (title != d->title) {
         d->title = title;
-        d->updateTitle();
+        if (Config::hasFlag(Config::Flag_CoalesceTitleChanges))
+            d->scheduleUpdateTitle();
+        else
+            d->updateTitle();
         d->titleChanged.emit(title);
     }
 }
@@ -511,7 +517,7 @@ void DockWidget::setAffinities(const Vector<QString> &affinityNames)
         return;
     }
 
-    d->affinities = affinities;
+    d->setAffinities(affinities);
 }
 
 void DockWidget::moveToSideBar()
@@ -750,6 +756,14 @@ void DockWidget::Private::updateTitle()
     toggleAction->setText(title);
 }
 
+void DockWidget::Private::scheduleUpdateTitle()
+{
+    if (!m_updateTitleScheduled) {
+        m_updateTitleScheduled = true;
+        Platform::instance()->runDelayed(0, new DelayedUpdateTitle(q));
+    }
+}
+
 void DockWidget::Private::toggle(bool enabled)
 {
     if (Core::SideBar *sb = sideBar()) {
@@ -948,7 +962,7 @@ Core::DockWidget *DockWidget::deserialize(const LayoutSaver::DockWidget::Ptr &sa
 
         if (dw->affinities() != saved->affinities) {
             KDDW_ERROR("Affinity name changed from {} to {}", dw->affinities(), "; to", saved->affinities);
-            dw->d->affinities = saved->affinities;
+            dw->d->setAffinities(saved->affinities);
         }
 
         dw->dptr()->m_lastCloseReason = saved->lastCloseReason;
@@ -1051,6 +1065,7 @@ DockWidget::Private::Private(const QString &dockName, DockWidgetOptions options_
                              LayoutSaverOptions layoutSaverOptions_, DockWidget *qq)
 
     : m_uniqueName(dockName)
+    , m_uniqueNameId(StringTable::self()->intern(dockName))
     , title(dockName)
     , q(qq)
     , options(options_)
@@ -1079,6 +1094,7 @@ DockWidget::Private::Private(const QString &dockName, DockWidgetOptions options_
 
         KDDW_TRACE("Emitting DockWidget::isFloatingChanged({})", checked);
         isFloatingChanged.emit(checked);
+        DockRegistry::self()->dptr()->layoutChanged.emit(nullptr);
 
         // When floating, we remove from the sidebar
         if (checked && q->isOpen()) {
@@ -1186,6 +1202,7 @@ void DockWidget::Private::setIsOpen(bool is)
 
     if (!is) {
         closed.emit();
+        DockRegistry::self()->dptr()->layoutChanged.emit(nullptr);
     }
 
     isOpenChanged.emit(is);
@@ -1202,9 +1219,16 @@ void DockWidget::Private::setUniqueName(const QString &name)
         KDDW_ERROR("DockWidget::Private::setUniqueName: Name is empty");
     } else {
         m_uniqueName = name;
+        m_uniqueNameId = StringTable::self()->intern(name);
     }
 }
 
+void DockWidget::Private::setAffinities(const Vector<QString> &affinities_)
+{
+    affinities = affinities_;
+    affinitySet = AffinitySet(affinities_);
+}
+
 void DockWidget::setFloatingWindowFlags(FloatingWindowFlags flags)
 {
     if (floatingWindow()) {
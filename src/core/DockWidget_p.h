@@ -18,6 +18,7 @@
 #include "Action.h"
 #include "core/View_p.h"
 #include "QtCompat_p.h"
+#include "core/AffinitySet_p.h"
 
 namespace KDDockWidgets {
 
@@ -118,6 +119,8 @@ public:
     void onWindowDeactivated(std::shared_ptr<View> rootView);
 
     void updateTitle();
+    /// Calls updateTitle() in the next event loop iteration, for Config::Flag_CoalesceTitleChanges
+    void scheduleUpdateTitle();
     void toggle(bool enabled);
     void updateToggleAction();
     void updateFloatAction();
@@ -261,12 +264,23 @@ public:
     /// to be called, unless you know what you're doing (like reusing dock widgets during restore)
     void setUniqueName(const QString &);
 
+    /// The interned id of uniqueName(). See StringTable.
+    int uniqueNameId() const
+    {
+        return m_uniqueNameId;
+    }
+
+    /// Sets both the affinities and their interned version
+    void setAffinities(const Vector<QString> &);
+
 private:
     // Go through the setter
     QString m_uniqueName;
+    int m_uniqueNameId = -1;
 
 public:
     Vector<QString> affinities;
+    AffinitySet affinitySet; // Interned version of the above, for cheap matching
     QString title;
     Icon titleBarIcon;
     Icon tabBarIcon;
@@ -291,6 +305,7 @@ public:
     bool m_inCloseEvent = false;
     bool m_removingFromOverlay = false;
     bool m_wasRestored = false;
+    bool m_updateTitleScheduled = false;
     Size m_lastOverlayedSize = Size(0, 0);
     int m_userType = 0;
     int m_willUpdateActions = 0;
@@ -26,6 +26,7 @@
 #include "core/FloatingWindow.h"
 #include "core/DockWidget_p.h"
 #include "core/ScopedValueRollback_p.h"
+#include "core/Tracing_p.h"
 
 #ifdef KDDW_FRONTEND_QT
 #include "../qtcommon/DragControllerWayland_p.h"
@@ -79,6 +80,11 @@ public:
         Platform::instance()->removeGlobalEventFilter(this);
     }
 
+    int eventInterests() const override
+    {
+        return EventInterest_AllMouse;
+    }
+
     bool onMouseEvent(View *, MouseEvent *me) override
     {
         if (m_reentrancyGuard || !m_guard)
@@ -169,6 +175,7 @@ StateNone::StateNone(DragController *parent)
 
 void StateNone::onEntry()
 {
+    KDDW_TRACE_INSTANT("dragging", "DragController: StateNone");
     KDDW_DEBUG("StateNone entered");
     q->m_pressPos = Point();
     q->m_offset = Point();
@@ -186,6 +193,9 @@ void StateNone::onEntry()
         q->m_currentDropArea = nullptr;
     }
 
+    // The drag ended, the overlays are only needed during the next one
+    DropArea::deleteDropIndicatorOverlays();
+
     /// Note that although this is unneedesly emitted at startup, there's nobody connected
     /// to it, since we're in DragController ctor, so it's fine.
     q->isDraggingChanged.emit();
@@ -226,6 +236,7 @@ StatePreDrag::~StatePreDrag() = default;
 
 void StatePreDrag::onEntry()
 {
+    KDDW_TRACE_INSTANT("dragging", "DragController: StatePreDrag");
     KDDW_DEBUG("StatePreDrag entered {}", q->m_draggableGuard.isNull());
     WidgetResizeHandler::s_disableAllHandlers = true; // Disable the resize handler during dragging
 }
@@ -293,6 +304,7 @@ StateDragging::~StateDragging() = default;
 
 void StateDragging::onEntry()
 {
+    KDDW_TRACE_INSTANT("dragging", "DragController: StateDragging");
 #if defined(KDDW_FRONTEND_QT_WINDOWS) && !defined(DOCKS_DEVELOPER_MODE)
     m_maybeCancelDrag.start();
 #endif
@@ -389,11 +401,19 @@ void StateDragging::onEntry()
         q->dragCanceled.emit();
     }
 
+    // The other windows don't move while we drag, no need to query their geometry on each mouse
+    // move. The window being dragged is excluded from the queries.
+    if (q->m_windowBeingDragged)
+        DockRegistry::self()->setTopLevelGeometriesFrozen(true);
+
     q->isDraggingChanged.emit();
 }
 
 void StateDragging::onExit()
 {
+    if (DockRegistry::isInitialized())
+        DockRegistry::self()->setTopLevelGeometriesFrozen(false);
+
 #if defined(KDDW_FRONTEND_QT_WINDOWS) && !defined(DOCKS_DEVELOPER_MODE)
     m_maybeCancelDrag.stop();
 #endif
@@ -511,6 +531,7 @@ StateInternalMDIDragging::~StateInternalMDIDragging()
 
 void StateInternalMDIDragging::onEntry()
 {
+    KDDW_TRACE_INSTANT("dragging", "DragController: StateInternalMDIDragging");
     KDDW_DEBUG("StateInternalMDIDragging entered. draggable={}", ( void * )q->m_draggable);
 
     if (!q->m_draggableGuard) {
@@ -1026,20 +1047,14 @@ std::shared_ptr<View> DragController::qtTopLevelUnderCursor() const
     } else {
         // !Windows: Linux, macOS, offscreen (offscreen on Windows too), etc.
 
-        // On Linux we don't have API to check the z-order of top-levels. So first check the
-        // floating windows and check the MainWindow last, as the MainWindow will have lower z-order
-        // as it's a parent (TODO: How will it work with multiple MainWindows ?) The floating window
-        // list is sorted by z-order, as we catch QEvent::Expose and move it to last of the list
+        // On Linux we don't have API to check the z-order of top-levels. DockRegistry tracks it
+        // instead, by catching QEvent::Expose and, with QtWidgets, window activation. Floating
+        // windows are always above the main windows, as the MainWindow will have lower z-order
+        // as it's a parent.
 
         FloatingWindow *floatingWindow = m_windowBeingDragged->floatingWindow();
-        if (floatingWindow) {
-            if (auto tl = qtTopLevelUnderCursor_impl(
-                    globalPos, DockRegistry::self()->floatingQWindows(), floatingWindow->view()))
-                return tl;
-
-            return qtTopLevelUnderCursor_impl(
-                globalPos, DockRegistry::self()->topLevels(/*excludeFloatingDocks=*/true), floatingWindow->view());
-        }
+        if (floatingWindow)
+            return DockRegistry::self()->topLevelAt(globalPos, floatingWindow->view());
     }
 
     KDDW_TRACE("No top-level found");
@@ -1047,14 +1062,14 @@ std::shared_ptr<View> DragController::qtTopLevelUnderCursor() const
 }
 
 static DropArea *deepestDropAreaInTopLevel(std::shared_ptr<View> topLevel, Point globalPos,
-                                           const Vector<QString> &affinities)
+                                           const AffinitySet &affinities)
 {
     const auto localPos = topLevel->mapFromGlobal(globalPos);
     auto view = topLevel->childViewAt(localPos);
 
     while (view) {
         if (auto dt = view->asDropAreaController()) {
-            if (DockRegistry::self()->affinitiesMatch(dt->affinities(), affinities))
+            if (affinitySetOf(dt).matches(affinities))
                 return dt;
         }
         view = view->parentView();
@@ -1074,10 +1089,10 @@ DropArea *DragController::dropAreaUnderCursor() const
         return nullptr;
     }
 
-    const Vector<QString> affinities = m_windowBeingDragged->floatingWindow()->affinities();
+    const AffinitySet &affinities = affinitySetOf(m_windowBeingDragged->floatingWindow());
 
     if (auto fw = topLevel->asFloatingWindowController()) {
-        if (DockRegistry::self()->affinitiesMatch(fw->affinities(), affinities)) {
+        if (affinitySetOf(fw).matches(affinities)) {
             KDDW_DEBUG("DragController::dropAreaUnderCursor: Found drop area in floating window");
             return fw->dropArea();
         }
@@ -21,8 +21,10 @@
 #include "core/layouting/Item_p.h"
 #include "core/layouting/LayoutingGuest_p.h"
 #include "core/layouting/LayoutingSeparator_p.h"
+#include "core/layouting/LayoutSolver_p.h"
 #include "core/WindowBeingDragged_p.h"
 #include "core/DelayedCall_p.h"
+#include "core/Tracing_p.h"
 #include "core/Group.h"
 #include "core/FloatingWindow.h"
 #include "core/DockWidget_p.h"
@@ -65,13 +67,22 @@ namespace Core {
 class DropArea::Private
 {
 public:
-    explicit Private(DropArea *q, MainWindowOptions options, bool isMDIWrapper)
-        : m_isMDIWrapper(isMDIWrapper)
-        , m_dropIndicatorOverlay(createDropIndicatorOverlay(q))
+    explicit Private(DropArea *qq, MainWindowOptions options, bool isMDIWrapper)
+        : q(qq)
+        , m_isMDIWrapper(isMDIWrapper)
         , m_centralGroup(createCentralGroup(options))
     {
     }
 
+    /// Returns the drop indicator overlay, creating it if needed.
+    DropIndicatorOverlay *dropIndicatorOverlay();
+
+    /// Each overlay has a native indicator window and a rubber band, so they're only kept while
+    /// dragging. These are the ones created during the current drag, see deleteDropIndicatorOverlays().
+    static std::vector<ObjectGuard<DropIndicatorOverlay>> s_createdOverlays;
+
+    DropArea *const q;
+
     bool m_inDestructor = false;
     const bool m_isMDIWrapper;
     QString m_affinityName;
@@ -84,6 +95,31 @@ public:
 
 }
 
+std::vector<ObjectGuard<DropIndicatorOverlay>> DropArea::Private::s_createdOverlays;
+
+DropIndicatorOverlay *DropArea::Private::dropIndicatorOverlay()
+{
+    if (!m_dropIndicatorOverlay) {
+        m_dropIndicatorOverlay = createDropIndicatorOverlay(q);
+        s_createdOverlays.push_back(m_dropIndicatorOverlay.data());
+    }
+
+    return m_dropIndicatorOverlay;
+}
+
+void DropArea::deleteDropIndicatorOverlays()
+{
+    auto overlays = std::move(Private::s_createdOverlays);
+    Private::s_createdOverlays.clear();
+
+    for (const auto &overlay : overlays) {
+        if (overlay && !overlay->isHovered())
+            delete overlay.data();
+        else if (overlay)
+            Private::s_createdOverlays.push_back(overlay);
+    }
+}
+
 DropArea::DropArea(View *parent, MainWindowOptions options, bool isMDIWrapper)
     : Layout(ViewType::DropArea, Config::self().viewFactory()->createDropArea(this, parent))
     , d(new Private(this, options, isMDIWrapper))
@@ -183,7 +219,12 @@ Core::Item *DropArea::centralFrame() const
 
 DropIndicatorOverlay *DropArea::dropIndicatorOverlay() const
 {
-    return d->m_dropIndicatorOverlay;
+    return d->dropIndicatorOverlay();
+}
+
+bool DropArea::hasDropIndicatorOverlay() const
+{
+    return d->m_dropIndicatorOverlay.data() != nullptr;
 }
 
 void DropArea::addDockWidget(Core::DockWidget *dw, Location location,
@@ -294,21 +335,23 @@ void DropArea::layoutParentContainerEqually(Core::DockWidget *dw)
 
 DropLocation DropArea::hover(WindowBeingDragged *draggedWindow, Point globalPos)
 {
+    KDDW_SCOPED_TRACE("docking", "DropArea::hover");
     if (Config::self().dropIndicatorsInhibited() || !validateAffinity(draggedWindow))
         return DropLocation_None;
 
-    if (!d->m_dropIndicatorOverlay) {
+    DropIndicatorOverlay *overlay = d->dropIndicatorOverlay();
+    if (!overlay) {
         KDDW_ERROR("The frontend is missing a drop indicator overlay");
         return DropLocation_None;
     }
 
     Core::Group *group = groupContainingPos(
         globalPos); // Group is nullptr if MainWindowOption_HasCentralFrame isn't set
-    d->m_dropIndicatorOverlay->setWindowBeingDragged(true);
-    d->m_dropIndicatorOverlay->setHoveredGroup(group);
+    overlay->setWindowBeingDragged(true);
+    overlay->setHoveredGroup(group);
     draggedWindow->updateTransparency(true);
 
-    return d->m_dropIndicatorOverlay->hover(globalPos);
+    return overlay->hover(globalPos);
 }
 
 static bool isOutterLocation(DropLocation location)
@@ -326,6 +369,7 @@ static bool isOutterLocation(DropLocation location)
 
 bool DropArea::drop(WindowBeingDragged *droppedWindow, Point globalPos)
 {
+    KDDW_SCOPED_TRACE("docking", "DropArea::drop");
     // fv might be null, if on wayland
     Core::View *fv = droppedWindow->floatingWindowView();
 
@@ -334,7 +378,7 @@ bool DropArea::drop(WindowBeingDragged *droppedWindow, Point globalPos)
         return false;
     }
 
-    if (d->m_dropIndicatorOverlay->currentDropLocation() == DropLocation_None) {
+    if (currentDropLocation() == DropLocation_None) {
         KDDW_DEBUG("DropArea::drop: bailing out, drop location = none");
         return false;
     }
@@ -449,6 +493,7 @@ bool DropArea::drop(WindowBeingDragged *draggedWindow, Core::Group *acceptingGro
 bool DropArea::drop(View *droppedWindow, KDDockWidgets::Location location,
                     Core::Group *relativeTo)
 {
+    KDDW_SCOPED_TRACE("docking", "DropArea::drop");
     KDDW_DEBUG("DropArea::drop");
 
     if (auto dock = droppedWindow->asDockWidgetController()) {
@@ -478,21 +523,22 @@ bool DropArea::drop(View *droppedWindow, KDDockWidgets::Location location,
 
 void DropArea::removeHover()
 {
-    d->m_dropIndicatorOverlay->removeHover();
+    if (d->m_dropIndicatorOverlay)
+        d->m_dropIndicatorOverlay->removeHover();
 }
 
 template<typename T>
 bool DropArea::validateAffinity(T *window, Core::Group *acceptingGroup) const
 {
-    if (!DockRegistry::self()->affinitiesMatch(window->affinities(), affinities())) {
+    const AffinitySet &windowAffinities = affinitySetOf(window);
+    if (!windowAffinities.matches(affinitySetOf(this))) {
         return false;
     }
 
     if (acceptingGroup) {
         // We're dropping into another group (as tabbed), so also check the affinity of the group
         // not only of the main window, which might be more forgiving
-        if (!DockRegistry::self()->affinitiesMatch(window->affinities(),
-                                                   acceptingGroup->affinities())) {
+        if (!windowAffinities.matches(affinitySetOf(acceptingGroup))) {
             return false;
         }
     }
@@ -682,6 +728,22 @@ void DropArea::layoutEqually()
     layoutEqually(d->m_rootItem);
 }
 
+void DropArea::layoutEquallyAsync(const std::function<void()> &onApplied)
+{
+    if (!checkSanity())
+        return;
+
+    auto solver = std::make_shared<Core::LayoutSolver>(d->m_rootItem);
+    solver->layoutEqually_recursive();
+    Layout::d_ptr()->solveAsync(solver, [this, onApplied](bool applied) {
+        if (!applied)
+            layoutEqually();
+
+        if (onApplied)
+            onApplied();
+    });
+}
+
 void DropArea::layoutEqually(Core::ItemBoxContainer *container)
 {
     if (container) {
@@ -65,7 +65,16 @@ public:
     Vector<Core::Group *> groups() const;
 
     Core::Item *centralFrame() const;
+
+    /// Returns the drop indicator overlay. It's created on demand, usually when first hovered.
     DropIndicatorOverlay *dropIndicatorOverlay() const;
+
+    /// Returns whether the drop indicator overlay was created already
+    bool hasDropIndicatorOverlay() const;
+
+    /// Deletes the drop indicator overlays which aren't being hovered. They're created on demand
+    /// while dragging and kept until the drag ends, so crossing drop areas doesn't recreate them.
+    static void deleteDropIndicatorOverlays();
     void addDockWidget(DockWidget *dw, KDDockWidgets::Location location, DockWidget *relativeTo,
                        const InitialOption &initialOption = {});
     void _addDockWidget(DockWidget *dw, KDDockWidgets::Location location, Item *relativeTo,
@@ -131,6 +140,9 @@ public:
     /// @brief overload that just resizes widgets within a sub-tree
     void layoutEqually(Core::ItemBoxContainer *);
 
+    /// @brief Like layoutEqually(), but calculated on a worker thread. See MainWindow::layoutEquallyAsync()
+    void layoutEquallyAsync(const std::function<void()> &onApplied = {});
+
     /// @brief Returns the number of items layed-out horizontally or vertically
     /// But honours nesting
     int numSideBySide_recursive(Qt::Orientation) const;
@@ -192,8 +192,7 @@ bool DropIndicatorOverlay::dropIndicatorVisible(DropLocation dropLoc) const
             return false;
 
         // Only allow to dock to center if the affinities match
-        if (!DockRegistry::self()->affinitiesMatch(m_hoveredGroup->affinities(),
-                                                   windowBeingDragged->affinities()))
+        if (!affinitySetOf(m_hoveredGroup).matches(windowBeingDragged->affinitySet()))
             return false;
     } else {
         KDDW_ERROR("Unknown drop indicator location={}", dropLoc);
@@ -29,8 +29,10 @@ class Group;
 ///   - Current hovered tab group
 ///   - Current window being dragged
 ///   - Current visible drop location
-/// Each DropArea has an associated DropIndicatorOverlay. Hence, each main window, each floating window
-/// has one DropIndicatorOverlay.
+/// Each DropArea has an associated DropIndicatorOverlay. It's only created when the DropArea is first
+/// hovered, and since only one drag happens at a time, it's deleted again when another DropArea needs
+/// one. Hence, there's usually a single DropIndicatorOverlay alive, regardless of how many main
+/// windows and floating windows there are.
 
 class DOCKS_EXPORT DropIndicatorOverlay : public Controller
 {
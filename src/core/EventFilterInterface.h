@@ -25,9 +25,35 @@ class View;
 class EventFilterInterface
 {
 public:
+    /// The kinds of events a global event filter can be interested in. See eventInterests().
+    enum EventInterest {
+        EventInterest_None = 0,
+        EventInterest_Expose = 1,
+        EventInterest_MouseButtonPress = 2,
+        EventInterest_MouseButtonRelease = 4,
+        EventInterest_MouseMove = 8,
+        EventInterest_MouseDoubleClick = 16,
+        EventInterest_NonClientAreaMouse = 32,
+        EventInterest_DnD = 64,
+        EventInterest_Move = 128,
+        EventInterest_AllMouse = EventInterest_MouseButtonPress | EventInterest_MouseButtonRelease
+            | EventInterest_MouseMove | EventInterest_MouseDoubleClick | EventInterest_NonClientAreaMouse,
+        EventInterest_All = 255
+    };
+
     EventFilterInterface() = default;
     virtual ~EventFilterInterface();
 
+    /// @brief Returns which events this filter wants, as a combination of EventInterest values
+    /// When installed as a global event filter, it's only called for these. Events that no filter is
+    /// interested in are rejected early, which matters as a global filter sees every event
+    /// of every object in the application.
+    /// Queried when the filter is installed. Default is EventInterest_All.
+    virtual int eventInterests() const
+    {
+        return EventInterest_All;
+    }
+
     /// @brief Override to handle expose events for a certain window
     virtual bool onExposeEvent(std::shared_ptr<Window>)
     {
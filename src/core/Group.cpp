@@ -43,6 +43,7 @@
 #include "core/Position_p.h"
 #include "core/WidgetResizeHandler_p.h"
 #include "core/DelayedCall_p.h"
+#include "core/Tracing_p.h"
 #include "core/layouting/Item_p.h"
 
 #include "kdbindings/signal.h"
@@ -86,6 +87,46 @@ static StackOptions tabWidgetOptions(FrameOptions options)
     return StackOption_None;
 }
 
+namespace {
+class DelayedEndTabSwitch : public DelayedCall
+{
+public:
+    explicit DelayedEndTabSwitch(Group *group)
+        : m_group(group)
+    {
+    }
+
+    void call() override
+    {
+        if (m_group)
+            m_group->dptr()->endTabSwitch();
+    }
+
+    KDDW_DELETE_COPY_CTOR(DelayedEndTabSwitch)
+private:
+    const ObjectGuard<Group> m_group;
+};
+
+class DelayedFlushTitleChanges : public DelayedCall
+{
+public:
+    explicit DelayedFlushTitleChanges(Group *group)
+        : m_group(group)
+    {
+    }
+
+    void call() override
+    {
+        if (m_group)
+            m_group->dptr()->flushPendingTitleChanges();
+    }
+
+    KDDW_DELETE_COPY_CTOR(DelayedFlushTitleChanges)
+private:
+    const ObjectGuard<Group> m_group;
+};
+}
+
 }
 
 Group::Group(View *parent, FrameOptions options, int userType)
@@ -99,7 +140,8 @@ Group::Group(View *parent, FrameOptions options, int userType)
     s_dbg_numFrames++;
     DockRegistry::self()->registerGroup(this);
 
-    m_tabBar->dptr()->currentDockWidgetChanged.connect([this] {
+    m_tabBar->dptr()->currentDockWidgetChanged.connect([this](DockWidget *dw) {
+        d->onCurrentDockWidgetChanged(dw);
         updateTitleAndIcon();
     });
 
@@ -218,13 +260,16 @@ void Group::onDockWidgetTitleChanged(DockWidget *dw)
 
     if (!m_inCtor) { // don't call pure virtual in ctor
         int index = indexOfDockWidget(dw);
-        renameTab(index, dw->title());
+        const QString title = dw->title();
+        if (m_tabBar->text(index) != title)
+            renameTab(index, title);
         changeTabIcon(index, dw->icon(IconPlace::TabBar));
     }
 }
 
 void Group::addTab(DockWidget *dockWidget, const InitialOption &addingOption)
 {
+    KDDW_SCOPED_TRACE("docking", "Group::addTab");
     insertWidget(dockWidget, dockWidgetCount(), addingOption); // append
 
     // The dock widget might have changed title *while* being inserted
@@ -289,10 +334,10 @@ void Group::insertWidget(DockWidget *dockWidget, int index, const InitialOption
     }
 
     KDBindings::ScopedConnection titleChangedConnection = dockWidget->d->titleChanged.connect(
-        [this, dockWidget] { onDockWidgetTitleChanged(dockWidget); });
+        [this, dockWidget] { d->onDockWidgetTitleOrIconChanged(dockWidget); });
 
     KDBindings::ScopedConnection iconChangedConnection = dockWidget->d->iconChanged.connect(
-        [this, dockWidget] { onDockWidgetTitleChanged(dockWidget); });
+        [this, dockWidget] { d->onDockWidgetTitleOrIconChanged(dockWidget); });
 
     d->titleChangedConnections[dockWidget] = std::move(titleChangedConnection);
     d->iconChangedConnections[dockWidget] = std::move(iconChangedConnection);
@@ -308,12 +353,15 @@ void Group::removeWidget(DockWidget *dw)
     if (it != d->iconChangedConnections.end())
         d->iconChangedConnections.erase(it);
 
+    d->m_pendingTitleChanges.removeOne(dw);
+
     if (auto gvi = dynamic_cast<Core::GroupViewInterface *>(view()))
         gvi->removeDockWidget(dw);
 }
 
 FloatingWindow *Group::detachTab(DockWidget *dockWidget)
 {
+    KDDW_SCOPED_TRACE("docking", "Group::detachTab");
     if (m_inCtor || m_inDtor)
         return nullptr;
 
@@ -1060,29 +1108,118 @@ Group::Private::Private(Group *qq, int userType, FrameOptions options)
     });
 
     q->view()->d->layoutInvalidated.connect([this] {
-        if (auto item = q->layoutItem()) {
+        onLayoutInvalidated();
+    });
+}
 
-            if (item->m_sizingInfo.minSize == minSize() && item->m_sizingInfo.maxSizeHint == maxSizeHint()) {
-                // No point in disturbing the layout if constraints didn't change.
-                // QTabWidget::resizeEvent for example will issue layout invalidation even if constraints haven't changed
-                return;
-            }
+void Group::Private::onLayoutInvalidated()
+{
+    if (auto item = q->layoutItem()) {
 
-            if (m_invalidatingLayout) {
-                // Fixes case where we're in the middle of adding a widget to layout and that triggers
-                // another unrelated widget to emit layoutInvalidated due to resize. It would trigger a relayout while
-                // we were in a middle of adding a dock widget.
-                // An example is QTabWidget::resizeEvent(), it calls updateGeometry() unconditionally.
-                return;
-            }
+        if (m_switchingTabsWithSameConstraints) {
+            // Fast path, see onCurrentDockWidgetChanged(). Not even worth querying the
+            // constraints, as that goes through every tab. endTabSwitch() checks them later,
+            // in case something else changed them meanwhile.
+            m_layoutInvalidationSuppressed = true;
+            return;
+        }
 
-            ScopedValueRollback guard(m_invalidatingLayout, true);
+        if (item->m_sizingInfo.minSize == minSize() && item->m_sizingInfo.maxSizeHint == maxSizeHint()) {
+            // No point in disturbing the layout if constraints didn't change.
+            // QTabWidget::resizeEvent for example will issue layout invalidation even if constraints haven't changed
+            return;
+        }
 
-            // Here we tell the KDDW layout that a widget change min/max sizes.
-            // KDDW will do some resizing to honour the new min/max constraint
-            safeEmitSignal(layoutInvalidated);
+        if (m_invalidatingLayout) {
+            // Fixes case where we're in the middle of adding a widget to layout and that triggers
+            // another unrelated widget to emit layoutInvalidated due to resize. It would trigger a relayout while
+            // we were in a middle of adding a dock widget.
+            // An example is QTabWidget::resizeEvent(), it calls updateGeometry() unconditionally.
+            return;
         }
-    });
+
+        ScopedValueRollback guard(m_invalidatingLayout, true);
+
+        // Here we tell the KDDW layout that a widget change min/max sizes.
+        // KDDW will do some resizing to honour the new min/max constraint
+        safeEmitSignal(layoutInvalidated);
+    }
+}
+
+void Group::Private::endTabSwitch()
+{
+    m_switchingTabsWithSameConstraints = false;
+    if (!m_layoutInvalidationSuppressed)
+        return;
+
+    m_layoutInvalidationSuppressed = false;
+
+    // The ignored invalidations were most likely caused by the tab switch itself. Only if the
+    // swapped tabs changed meanwhile is the full comparison over every tab needed.
+    const TabSwitch &tabSwitch = m_tabSwitch;
+    const bool unchanged = tabSwitch.previous && tabSwitch.current
+        && q->currentDockWidget() == tabSwitch.current.data()
+        && q->dockWidgetCount() == tabSwitch.dockWidgetCount
+        && q->containsDockWidget(tabSwitch.previous)
+        && tabSwitch.previous->view()->minSize() == tabSwitch.minSize
+        && tabSwitch.current->view()->minSize() == tabSwitch.minSize
+        && tabSwitch.previous->view()->maxSizeHint() == tabSwitch.maxSizeHint
+        && tabSwitch.current->view()->maxSizeHint() == tabSwitch.maxSizeHint;
+
+    if (!unchanged)
+        onLayoutInvalidated();
+}
+
+void Group::Private::onCurrentDockWidgetChanged(Core::DockWidget *current)
+{
+    Core::DockWidget *previous = m_previousCurrentDockWidget;
+    m_previousCurrentDockWidget = current;
+
+    if (!previous || !current || previous == current || !q->layoutItem()
+        || !q->containsDockWidget(previous))
+        return;
+
+    const Size minSize = current->view()->minSize();
+    const Size maxSizeHint = current->view()->maxSizeHint();
+    if (previous->view()->minSize() != minSize || previous->view()->maxSizeHint() != maxSizeHint)
+        return;
+
+    m_tabSwitch = { previous, current, minSize, maxSizeHint, q->dockWidgetCount() };
+
+    // The frontend's stack processes the show/hide of the tabs right away or in the next event
+    // loop iteration, so keep ignoring invalidations until then
+    if (!m_switchingTabsWithSameConstraints) {
+        m_switchingTabsWithSameConstraints = true;
+        Platform::instance()->runDelayed(0, new DelayedEndTabSwitch(q));
+    }
+}
+
+void Group::Private::onDockWidgetTitleOrIconChanged(Core::DockWidget *dw)
+{
+    if (!Config::hasFlag(Config::Flag_CoalesceTitleChanges)) {
+        q->onDockWidgetTitleChanged(dw);
+        return;
+    }
+
+    if (!m_pendingTitleChanges.contains(dw))
+        m_pendingTitleChanges.push_back(dw);
+
+    if (!m_titleChangesScheduled) {
+        m_titleChangesScheduled = true;
+        Platform::instance()->runDelayed(0, new DelayedFlushTitleChanges(q));
+    }
+}
+
+void Group::Private::flushPendingTitleChanges()
+{
+    m_titleChangesScheduled = false;
+    const auto docks = std::move(m_pendingTitleChanges);
+    m_pendingTitleChanges.clear();
+
+    for (Core::DockWidget *dw : docks) {
+        if (q->containsDockWidget(dw))
+            q->onDockWidgetTitleChanged(dw);
+    }
 }
 
 Group::Private::~Private()
@@ -120,10 +120,44 @@ public:
         return m_options & FrameOption_IsCentralFrame ? IsCentralFrame : None;
     }
 
+    /// Called when the current tab changes. If the new and previous current dock widgets have the
+    /// same constraints, then the group's constraints didn't change either, so the layout
+    /// invalidations caused by the frontend showing and hiding the tabs are ignored.
+    void onCurrentDockWidgetChanged(Core::DockWidget *current);
+
+    /// Called when the view's layout is invalidated. Propagates it to the layout if the group's
+    /// constraints changed.
+    void onLayoutInvalidated();
+
+    /// Ends the tab switch started in onCurrentDockWidgetChanged(). If a layout invalidation was
+    /// ignored meanwhile and the swapped tabs changed since, it's processed now.
+    void endTabSwitch();
+
+    /// Propagates a dock widget's title or icon change to the title bar, tab bar and window.
+    /// With Config::Flag_CoalesceTitleChanges it's done once, in the next event loop iteration.
+    void onDockWidgetTitleOrIconChanged(Core::DockWidget *);
+    void flushPendingTitleChanges();
+
     Group *const q;
     int m_userType = 0;
     FrameOptions m_options = FrameOption_None;
     bool m_invalidatingLayout = false;
+    bool m_switchingTabsWithSameConstraints = false;
+    bool m_layoutInvalidationSuppressed = false;
+    ObjectGuard<Core::DockWidget> m_previousCurrentDockWidget;
+
+    /// The last tab switch between dock widgets with the same constraints
+    struct TabSwitch
+    {
+        ObjectGuard<Core::DockWidget> previous;
+        ObjectGuard<Core::DockWidget> current;
+        Size minSize;
+        Size maxSizeHint;
+        int dockWidgetCount = 0;
+    };
+    TabSwitch m_tabSwitch;
+    Vector<Core::DockWidget *> m_pendingTitleChanges;
+    bool m_titleChangesScheduled = false;
 };
 
 }
@@ -11,6 +11,7 @@
 
 #include "Layout.h"
 #include "Layout_p.h"
+#include "DelayedCall_p.h"
 #include "LayoutSaver_p.h"
 #include "Position_p.h"
 #include "Config.h"
@@ -22,11 +23,16 @@
 #include "ScopedValueRollback_p.h"
 #include "DropArea.h"
 #include "DockWidget_p.h"
+#include "DockRegistry_p.h"
 #include "Group.h"
 #include "FloatingWindow.h"
 #include "MainWindow.h"
 #include "layouting/Item_p.h"
+#include "layouting/LayoutSolver_p.h"
 
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <unordered_map>
 
 using namespace KDDockWidgets;
@@ -103,7 +109,12 @@ void Layout::setRootItem(Core::ItemContainer *root)
     delete d->m_rootItem;
     d->m_rootItem = root;
     d->m_rootItem->numVisibleItemsChanged.connect(
-        [this](int count) { d->visibleWidgetCountChanged.emit(count); });
+        [this](int count) {
+            d->visibleWidgetCountChanged.emit(count);
+            d->scheduleCollectPlaceholders();
+        });
+    d->m_rootItem->numItemsChanged.connect(
+        [this] { DockRegistry::self()->dptr()->layoutChanged.emit(this); });
 
     d->m_minSizeChangedHandler =
         d->m_rootItem->minSizeChanged.connect([this] { view()->setMinimumSize(layoutMinimumSize()); });
@@ -187,22 +198,60 @@ void Layout::unrefOldPlaceholders(const Core::Group::List &groupsBeingAdded) con
     }
 }
 
+static ChildrenResizeStrategy childrenResizeStrategy(const Core::MainWindow *main)
+{
+    if (!LayoutSaver::restoreInProgress() && main && main->options() & MainWindowOption_CentralWidgetGetsAllExtraSpace)
+        return ChildrenResizeStrategy::GiveDropAreaWithCentralFrameAllExtra;
+
+    return ChildrenResizeStrategy::Percentage;
+}
+
 void Layout::setLayoutSize(Size size)
 {
+    ++d->m_layoutSizeGeneration;
     if (size != layoutSize()) {
-        const bool restoreInProgress = LayoutSaver::restoreInProgress();
-        ChildrenResizeStrategy strategy = ChildrenResizeStrategy::Percentage;
-        const auto *main = mainWindow();
-        if (!restoreInProgress && main && main->options() & MainWindowOption_CentralWidgetGetsAllExtraSpace)
-            strategy = ChildrenResizeStrategy::GiveDropAreaWithCentralFrameAllExtra;
+        d->m_rootItem->setSize_recursive(size, childrenResizeStrategy(mainWindow()));
 
-        d->m_rootItem->setSize_recursive(size, strategy);
-
-        if (!d->m_inResizeEvent && !restoreInProgress)
+        if (!d->m_inResizeEvent && !LayoutSaver::restoreInProgress())
             view()->resize(size);
     }
 }
 
+void Layout::setLayoutSizeAsync(Size size, const std::function<void()> &onApplied)
+{
+    auto root = d->m_rootItem->asBoxContainer();
+    const Size minSize = layoutMinimumSize();
+    const bool tooSmall = size.width() < minSize.width() || size.height() < minSize.height();
+    if (!root || tooSmall || size == layoutSize() || LayoutSaver::restoreInProgress()) {
+        // Nothing worth doing in the background
+        setLayoutSize(size);
+        if (onApplied)
+            onApplied();
+        return;
+    }
+
+    const int generation = ++d->m_layoutSizeGeneration;
+    auto solver = std::make_shared<LayoutSolver>(root);
+    solver->setSize_recursive(size, childrenResizeStrategy(mainWindow()));
+    // If a newer size was requested meanwhile then this one is obsolete, don't undo it.
+    // Not even if the layout's geometry didn't change, as the newer size might be the current one.
+    const auto isObsolete = [this, generation] { return generation != d->m_layoutSizeGeneration; };
+
+    d->solveAsync(
+        solver, [this, size, isObsolete, onApplied](bool applied) {
+            if (!applied) {
+                if (!isObsolete())
+                    setLayoutSize(size);
+            } else if (!d->m_inResizeEvent) {
+                view()->resize(size);
+            }
+
+            if (onApplied)
+                onApplied();
+        },
+        isObsolete);
+}
+
 Core::Item::List Layout::items() const
 {
     return d->m_rootItem->items_recursive();
@@ -233,6 +282,62 @@ int Layout::placeholderCount() const
     return count() - visibleCount();
 }
 
+int Layout::evictedPlaceholderCount() const
+{
+    return d->m_numEvictedPlaceholders;
+}
+
+void Layout::collectPlaceholders()
+{
+    d->m_collectPlaceholdersScheduled = false;
+
+    const int maxPlaceholders = Config::self().maxPlaceholdersPerLayout();
+    if (maxPlaceholders <= 0 || LayoutSaver::restoreInProgress())
+        return;
+
+    Core::Item::List placeholders;
+    const Core::Item::List allItems = items();
+    for (Core::Item *item : allItems) {
+        if (item->isPlaceholder())
+            placeholders.push_back(item);
+    }
+
+    int numToEvict = int(placeholders.size()) - maxPlaceholders;
+    if (numToEvict <= 0)
+        return;
+
+    // Least recently used first
+    std::sort(placeholders.begin(), placeholders.end(), [](Core::Item *a, Core::Item *b) {
+        return a->hiddenSerial() < b->hiddenSerial();
+    });
+
+    const Core::DockWidget::List allDockWidgets = DockRegistry::self()->dockwidgets();
+    for (Core::Item *item : std::as_const(placeholders)) {
+        if (numToEvict == 0)
+            break;
+
+        Core::DockWidget::List owners;
+        bool inSideBar = false;
+        for (Core::DockWidget *dw : allDockWidgets) {
+            if (dw->d->lastPosition()->containsPlaceholder(item)) {
+                owners.push_back(dw);
+                inSideBar = inSideBar || dw->isInSideBar();
+            }
+        }
+
+        // Side bar dock widgets still need their placeholder to be unpinned back
+        if (inSideBar || owners.isEmpty())
+            continue;
+
+        // Removing the last reference deletes the item
+        for (Core::DockWidget *dw : std::as_const(owners))
+            dw->d->lastPosition()->removePlaceholder(item);
+
+        ++d->m_numEvictedPlaceholders;
+        --numToEvict;
+    }
+}
+
 Core::Item *Layout::itemForGroup(const Core::Group *group) const
 {
     if (!group)
@@ -403,6 +508,92 @@ Layout::Private::Private(Layout *qq)
 
 Layout::Private::~Private() = default;
 
+namespace {
+class DelayedCollectPlaceholders : public DelayedCall
+{
+public:
+    explicit DelayedCollectPlaceholders(Layout *layout)
+        : m_layout(layout)
+    {
+    }
+
+    void call() override
+    {
+        if (m_layout)
+            m_layout->collectPlaceholders();
+    }
+
+    KDDW_DELETE_COPY_CTOR(DelayedCollectPlaceholders)
+private:
+    const ObjectGuard<Layout> m_layout;
+};
+
+class DelayedApplyLayoutSolver : public DelayedCall
+{
+public:
+    DelayedApplyLayoutSolver(Layout *layout, const std::shared_ptr<LayoutSolver> &solver,
+                             const std::shared_future<void> &solved,
+                             const std::function<bool()> &isObsolete,
+                             const std::function<void(bool)> &onFinished)
+        : m_layout(layout)
+        , m_solver(solver)
+        , m_solved(solved)
+        , m_isObsolete(isObsolete)
+        , m_onFinished(onFinished)
+    {
+    }
+
+    void call() override
+    {
+        if (!m_layout)
+            return;
+
+        if (m_solved.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            // Platform has no way to be woken up from another thread, so poll
+            Platform::instance()->runDelayed(
+                PollInterval, new DelayedApplyLayoutSolver(m_layout, m_solver, m_solved, m_isObsolete, m_onFinished));
+            return;
+        }
+
+        if (m_isObsolete && m_isObsolete()) {
+            m_onFinished(false);
+            return;
+        }
+
+        m_onFinished(m_solver->apply());
+    }
+
+    KDDW_DELETE_COPY_CTOR(DelayedApplyLayoutSolver)
+private:
+    static constexpr int PollInterval = 5;
+    const ObjectGuard<Layout> m_layout;
+    const std::shared_ptr<LayoutSolver> m_solver;
+    // Declared after m_solver, as destroying the last future waits for the worker thread
+    const std::shared_future<void> m_solved;
+    const std::function<bool()> m_isObsolete;
+    const std::function<void(bool)> m_onFinished;
+};
+}
+
+void Layout::Private::solveAsync(const std::shared_ptr<LayoutSolver> &solver,
+                                 const std::function<void(bool)> &onFinished,
+                                 const std::function<bool()> &isObsolete)
+{
+    const std::shared_future<void> solved = solver->solveAsync().share();
+    Platform::instance()->runDelayed(0, new DelayedApplyLayoutSolver(q, solver, solved, isObsolete, onFinished));
+}
+
+void Layout::Private::scheduleCollectPlaceholders()
+{
+    // Deferred, so closing many dock widgets at once only collects once, and never while
+    // the layout is being modified
+    if (m_collectPlaceholdersScheduled || Config::self().maxPlaceholdersPerLayout() <= 0)
+        return;
+
+    m_collectPlaceholdersScheduled = true;
+    Platform::instance()->runDelayed(0, new DelayedCollectPlaceholders(q));
+}
+
 
 /** static */
 Layout *Layout::fromLayoutingHost(LayoutingHost *host)
@@ -30,6 +30,8 @@
 #include "kddockwidgets/LayoutSaver.h"
 #include "kddockwidgets/QtCompat_p.h"
 
+#include <functional>
+
 namespace KDDockWidgets {
 
 namespace Core {
@@ -120,6 +122,18 @@ public:
      */
     void setLayoutSize(Size);
 
+    /**
+     * @brief Like setLayoutSize(), but the new geometries are calculated on a worker thread and
+     * applied later, in one go. Useful for big layouts, such as after a screen change.
+     * KDDockWidgets doesn't call it itself, resize events and screen changes still resize
+     * synchronously, as the view already has its new size by then. Applications can call it
+     * when they resize a big layout programmatically.
+     * @p onApplied is called once done. If the layout changes meanwhile, the result is discarded
+     * and setLayoutSize() is called instead. If a newer layout size was requested meanwhile,
+     * the result is discarded and the requested size is simply dropped.
+     */
+    void setLayoutSizeAsync(Size, const std::function<void()> &onApplied = {});
+
 
     /// @brief restores the dockwidget @p dw to its previous position
     void restorePlaceholder(Core::DockWidget *dw, Core::Item *, int tabIndex);
@@ -160,6 +174,19 @@ public:
      */
     int placeholderCount() const;
 
+    /**
+     * @brief Returns how many placeholders were removed so far for being over the
+     * Config::maxPlaceholdersPerLayout() budget
+     */
+    int evictedPlaceholderCount() const;
+
+    /**
+     * @brief Removes the placeholders that have been hidden the longest, until this layout is within
+     * the Config::maxPlaceholdersPerLayout() budget.
+     * This is already done automatically after dock widgets are closed.
+     */
+    void collectPlaceholders();
+
     /**
      * @brief returns the Item that holds @p group in this layout
      */
@@ -16,6 +16,7 @@
 #include "kddockwidgets/LayoutSaver.h"
 #include "kddockwidgets/core/Platform.h"
 #include "core/Window_p.h"
+#include "core/AffinitySet_p.h"
 #include "nlohmann_helpers_p.h"
 
 #include <memory>
@@ -108,7 +109,8 @@ struct DOCKS_EXPORT LayoutSaver::DockWidget
     // Using shared ptr, as we need to modify shared instances
     typedef std::shared_ptr<LayoutSaver::DockWidget> Ptr;
     typedef Vector<Ptr> List;
-    static std::map<QString, Ptr> s_dockWidgets;
+    // Keyed by the interned unique name, see StringTable
+    static std::unordered_map<int, Ptr> s_dockWidgets;
 
     bool isValid() const;
 
@@ -118,13 +120,14 @@ struct DOCKS_EXPORT LayoutSaver::DockWidget
 
     static Ptr dockWidgetForName(const QString &name)
     {
-        auto it = s_dockWidgets.find(name);
+        const int nameId = StringTable::self()->intern(name);
+        auto it = s_dockWidgets.find(nameId);
         auto dw = it == s_dockWidgets.cend() ? nullptr : it->second;
         if (dw)
             return dw;
 
         dw = Ptr(new LayoutSaver::DockWidget);
-        s_dockWidgets[name] = dw;
+        s_dockWidgets[nameId] = dw;
         dw->uniqueName = name;
 
         return dw;
@@ -132,6 +135,10 @@ struct DOCKS_EXPORT LayoutSaver::DockWidget
 
     bool skipsRestore() const;
 
+    /// Returns this dock widget's json, as it appears in allDockWidgets
+    /// Used by LayoutAutoSaver to find which dock widgets changed
+    QByteArray toJson() const;
+
     QString uniqueName;
     Vector<QString> affinities;
     LayoutSaver::Position lastPosition;
@@ -333,9 +340,16 @@ public:
     static void restorePendingPositions(Core::DockWidget *);
 
     bool matchesAffinity(const Vector<QString> &affinities) const;
+
+    /// Fills @p layout with the current state. Returns false if the current state isn't sane.
+    bool serializeTo(LayoutSaver::Layout &layout);
     void floatWidgetsWhichSkipRestore(const Vector<QString> &mainWindowNames);
     void floatUnknownWidgets(const LayoutSaver::Layout &layout);
 
+    /// Passes the dock widgets which @p layout needs, but don't exist, to the
+    /// DockWidgetBatchFactoryFunc, if any
+    void createMissingDockWidgets(const LayoutSaver::Layout &layout) const;
+
     template<typename T>
     void deserializeWindowGeometry(const T &saved, Core::Window::Ptr);
     void deleteEmptyGroups() const;
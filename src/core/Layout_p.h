@@ -15,8 +15,13 @@
 #include "layouting/LayoutingHost_p.h"
 #include "kdbindings/signal.h"
 
+#include <functional>
+#include <memory>
+
 namespace KDDockWidgets::Core {
 
+class LayoutSolver;
+
 class Layout::Private : public LayoutingHost
 {
 public:
@@ -32,6 +37,21 @@ public:
     KDBindings::Signal<int> visibleWidgetCountChanged;
 
     bool m_viewDeleted = false;
+
+    /// @brief Schedules collectPlaceholders(), if there's a placeholder budget
+    void scheduleCollectPlaceholders();
+    bool m_collectPlaceholdersScheduled = false;
+    int m_numEvictedPlaceholders = 0;
+
+    /// @brief Incremented on each layout size request, so stale async results can be dropped
+    int m_layoutSizeGeneration = 0;
+
+    /// @brief Runs @p solver on a worker thread and applies the result on the GUI thread
+    /// @p onFinished is called with false if the layout changed meanwhile and nothing was applied,
+    /// or if @p isObsolete returns true by then
+    void solveAsync(const std::shared_ptr<LayoutSolver> &solver,
+                    const std::function<void(bool applied)> &onFinished,
+                    const std::function<bool()> &isObsolete = {});
 };
 
 }
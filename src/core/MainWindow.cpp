@@ -86,7 +86,7 @@ void MainWindow::addDockWidgetAsTab(Core::DockWidget *widget)
     assert(widget);
     KDDW_DEBUG("dock={}", ( void * )widget);
 
-    if (!DockRegistry::self()->affinitiesMatch(d->affinities, widget->affinities())) {
+    if (!d->affinitySet.matches(affinitySetOf(widget))) {
         KDDW_ERROR("Refusing to dock widget with incompatible affinity. {} {}", widget->affinities(), affinities());
         return;
     }
@@ -129,6 +129,22 @@ void MainWindow::addDockWidget(Core::DockWidget *dw, Location location,
     dropArea()->addDockWidget(dw, location, relativeTo, option);
 }
 
+void MainWindow::beginBatchInsertion()
+{
+    if (isMDI())
+        return;
+
+    dropArea()->rootItem()->beginBatch();
+}
+
+void MainWindow::endBatchInsertion()
+{
+    if (isMDI())
+        return;
+
+    dropArea()->rootItem()->endBatch();
+}
+
 void MainWindow::addDockWidgetToSide(KDDockWidgets::Core::DockWidget *dockWidget,
                                      KDDockWidgets::Location location, const KDDockWidgets::InitialOption &initialOption)
 {
@@ -228,7 +244,7 @@ void MainWindow::setAffinities(const Vector<QString> &affinityNames)
         return;
     }
 
-    d->affinities = affinities;
+    d->setAffinities(affinities);
 }
 
 Vector<QString> MainWindow::affinities() const
@@ -241,6 +257,11 @@ void MainWindow::layoutEqually()
     dropArea()->layoutEqually();
 }
 
+void MainWindow::layoutEquallyAsync(const std::function<void()> &onApplied)
+{
+    dropArea()->layoutEquallyAsync(onApplied);
+}
+
 void MainWindow::layoutParentContainerEqually(Core::DockWidget *dockWidget)
 {
     dropArea()->layoutParentContainerEqually(dockWidget);
@@ -519,6 +540,12 @@ Rect MainWindow::Private::windowGeometry() const
     return q->window()->geometry();
 }
 
+void MainWindow::Private::setAffinities(const Vector<QString> &affinities_)
+{
+    affinities = affinities_;
+    affinitySet = AffinitySet(affinities_);
+}
+
 void MainWindow::moveToSideBar(Core::DockWidget *dw)
 {
     moveToSideBar(dw, d->preferredSideBar(dw));
@@ -742,7 +769,7 @@ bool MainWindow::deserialize(const LayoutSaver::MainWindow &mw)
     if (d->affinities != mw.affinities) {
         KDDW_ERROR("Affinity name changed from {} to {}", d->affinities, mw.affinities);
 
-        d->affinities = mw.affinities;
+        d->setAffinities(mw.affinities);
     }
 
     // Restore the SideBars
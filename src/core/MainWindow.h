@@ -25,10 +25,14 @@
 #include "kddockwidgets/LayoutSaver.h"
 #include "kddockwidgets/core/Controller.h"
 
+#include <functional>
+
 class TestDocks;
 
 namespace KDDockWidgets {
 
+class LayoutAutoSaver;
+
 namespace QtWidgets {
 class MainWindow;
 }
@@ -50,6 +54,7 @@ class Group;
 class Layout;
 class SideBar;
 class DockWidget;
+class AffinitySet;
 
 /**
  * @brief The MainWindow base-class. MainWindow and MainWindowBase are only
@@ -92,6 +97,22 @@ public:
                        KDDockWidgets::Core::DockWidget *relativeTo = nullptr,
                        const KDDockWidgets::InitialOption &initialOption = {});
 
+    /**
+     * @brief Starts a batch of dock widget insertions.
+     *
+     * Each addDockWidget() call updates the separators, the dock widget geometries and the
+     * title bars, which is slow when adding hundreds of dock widgets programmatically.
+     * Until endBatchInsertion() is called only the layout itself is calculated, the rest is
+     * done once at the end. Meanwhile the layout has no separators, so it can't be resized
+     * interactively, but it can be queried and saved.
+     *
+     * Calls can be nested. Not applicable to MDI.
+     */
+    void beginBatchInsertion();
+
+    /// @brief Ends a batch of dock widget insertions. See beginBatchInsertion().
+    void endBatchInsertion();
+
     // dev mode only for now, as it still has bugs.
     // We need to be able to dock to relativeTo=hidden dock
     /**
@@ -165,6 +186,12 @@ public:
     /// min/max constraints will still be honoured.
     void layoutEqually();
 
+    /// @brief like layoutEqually() but the new geometries are calculated on a worker thread,
+    /// so the event loop stays responsive for very big layouts.
+    /// They are applied later, all at once, after which @p onApplied is called.
+    /// If the layout changes meanwhile, the result is discarded and layoutEqually() is called instead.
+    void layoutEquallyAsync(const std::function<void()> &onApplied = {});
+
     /// @brief like layoutEqually() but starts with the container that has @p dockWidget.
     /// While layoutEqually() starts from the root of the layout tree this function starts on a
     /// sub-tree.
@@ -281,6 +308,8 @@ private:
     friend class KDDockWidgets::Core::MainWindowViewInterface;
     friend class ::TestDocks;
     friend class KDDockWidgets::LayoutSaver;
+    friend class KDDockWidgets::LayoutAutoSaver;
+    friend const AffinitySet &affinitySetOf(const MainWindow *);
     bool deserialize(const LayoutSaver::MainWindow &);
     LayoutSaver::MainWindow serialize() const;
 };
@@ -19,6 +19,7 @@
 #include "DropArea.h"
 #include "DockWidget_p.h"
 #include "Group.h"
+#include "AffinitySet_p.h"
 
 #include <kdbindings/signal.h>
 
@@ -108,8 +109,12 @@ public:
     void clearSideBars();
     Rect windowGeometry() const;
 
+    /// Sets both the affinities and their interned version
+    void setAffinities(const Vector<QString> &);
+
     QString name;
     Vector<QString> affinities;
+    AffinitySet affinitySet; // Interned version of the above, for cheap matching
     const MainWindowOptions m_options;
     MainWindow *const q;
     ObjectGuard<Core::DockWidget> m_overlayedDockWidget;
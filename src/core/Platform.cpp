@@ -258,6 +258,7 @@ void Platform::tests_deinitPlatform()
 void Platform::installGlobalEventFilter(EventFilterInterface *filter)
 {
     d->m_globalEventFilters.push_back(filter);
+    d->onGlobalEventFiltersChanged();
 }
 
 void Platform::removeGlobalEventFilter(EventFilterInterface *filter)
@@ -265,6 +266,16 @@ void Platform::removeGlobalEventFilter(EventFilterInterface *filter)
     d->m_globalEventFilters.erase(
         std::remove(d->m_globalEventFilters.begin(), d->m_globalEventFilters.end(), filter),
         d->m_globalEventFilters.end());
+    d->onGlobalEventFiltersChanged();
+}
+
+void Platform::Private::onGlobalEventFiltersChanged()
+{
+    m_globalEventInterests = 0;
+    for (EventFilterInterface *filter : std::as_const(m_globalEventFilters))
+        m_globalEventInterests |= filter->eventInterests();
+
+    ++m_globalEventFiltersChangeCount;
 }
 
 void Platform::onFloatingWindowCreated(Core::FloatingWindow *)
@@ -42,7 +42,16 @@ public:
 
     bool m_inDestruction = false;
 
+    /// Updates the cached state after a global event filter was installed or removed
+    void onGlobalEventFiltersChanged();
+
     std::vector<EventFilterInterface *> m_globalEventFilters;
+
+    /// The union of the global event filters' EventFilterInterface::eventInterests()
+    int m_globalEventInterests = 0;
+
+    /// Incremented whenever a global event filter is installed or removed
+    unsigned int m_globalEventFiltersChangeCount = 0;
 };
 
 }
@@ -169,6 +169,13 @@ int Positions::placeholderCount() const
     return int(m_placeholders.size());
 }
 
+size_t Positions::estimatedBytes() const
+{
+    return sizeof(Positions) + m_placeholders.capacity() * sizeof(std::unique_ptr<ItemRef>)
+        + m_placeholders.size() * sizeof(ItemRef)
+        + m_lastOverlayedGeometries.size() * sizeof(std::pair<SideBarLocation, Rect>);
+}
+
 void Positions::deserialize(const LayoutSaver::Position &lp)
 {
     m_lastFloatingGeometry = lp.lastFloatingGeometry;
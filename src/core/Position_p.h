@@ -93,6 +93,9 @@ public:
     /// We don't support memorizing more than 1 main window or more than 1 floating window
     int placeholderCount() const;
 
+    /// Roughly how many bytes this instance and its placeholder bookkeeping use
+    size_t estimatedBytes() const;
+
     void saveTabIndex(int tabIndex, bool isFloating)
     {
         m_tabIndex = tabIndex;
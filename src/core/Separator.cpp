@@ -19,6 +19,8 @@
 #include "Platform.h"
 #include "Controller.h"
 #include "core/ViewFactory.h"
+#include "core/DockRegistry.h"
+#include "core/DockRegistry_p.h"
 
 
 #ifdef Q_OS_WIN
@@ -84,6 +86,7 @@ struct Separator::Private : public LayoutingSeparator
     Core::Separator *const q;
     Rect m_geometry;
     int lazyPosition = 0;
+    int positionOnPress = 0;
     View *lazyResizeRubberBand = nullptr;
     const bool usesLazyResize = Config::self().flags() & Config::Flag_LazyResize;
 };
@@ -169,6 +172,7 @@ bool Separator::usesLazyResize() const
 void Separator::onMousePress()
 {
     d->onMousePress();
+    d->positionOnPress = position();
 
     KDDW_DEBUG("Drag started");
 
@@ -188,13 +192,20 @@ void Separator::onMouseReleased()
     }
 
     d->onMouseRelease();
+
+    // A click without dragging doesn't change the layout
+    if (position() != d->positionOnPress)
+        DockRegistry::self()->dptr()->layoutChanged.emit(DockRegistry::self()->layoutForItem(d->m_parentContainer));
 }
 
 void Separator::onMouseDoubleClick()
 {
     // a double click means we'll resize the left and right neighbour so that they occupy
     // the same size (or top/bottom, depending on orientation).
+    const int oldPosition = position();
     d->m_parentContainer->requestEqualSize(d);
+    if (position() != oldPosition)
+        DockRegistry::self()->dptr()->layoutChanged.emit(DockRegistry::self()->layoutForItem(d->m_parentContainer));
 }
 
 void Separator::onMouseMove(Point pos)
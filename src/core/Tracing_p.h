@@ -0,0 +1,126 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "kddockwidgets/Tracing.h"
+
+/// Trace events are only compiled in with -DKDDockWidgets_TRACING=ON, otherwise the macros expand
+/// to nothing. Even when compiled in, they cost a single atomic load while no TraceSink is set.
+///
+/// KDDW_SCOPED_TRACE(category, name) traces the enclosing scope.
+/// KDDW_TRACE_INSTANT(category, name) traces a point in time.
+/// KDDW_TRACE_PHASE(name) ends the previous phase of the enclosing scope and starts a new one,
+/// so long functions can be split without adding nested scopes. Requires KDDW_SCOPED_TRACE_PHASES().
+
+#ifdef KDDW_TRACING
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace KDDockWidgets {
+
+inline int64_t traceTimestampUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+inline uint64_t traceThreadId()
+{
+    return uint64_t(std::hash<std::thread::id>()(std::this_thread::get_id()));
+}
+
+inline void traceInstantEvent(const char *category, const char *name)
+{
+    if (TraceSink *sink = TraceSink::current()) {
+        TraceEvent event;
+        event.name = name;
+        event.category = category;
+        event.timestampUs = traceTimestampUs();
+        event.threadId = traceThreadId();
+        sink->addEvent(event);
+    }
+}
+
+/// Sends a complete event when going out of scope, or when the next phase starts
+class ScopedTraceEvent
+{
+public:
+    ScopedTraceEvent(const char *category, const char *name)
+        : m_sink(TraceSink::current())
+    {
+        start(category, name);
+    }
+
+    ~ScopedTraceEvent()
+    {
+        finish();
+    }
+
+    void nextPhase(const char *name)
+    {
+        finish();
+        start(m_event.category, name);
+    }
+
+private:
+    void start(const char *category, const char *name)
+    {
+        if (!m_sink)
+            return;
+
+        m_event.name = name;
+        m_event.category = category;
+        m_event.timestampUs = traceTimestampUs();
+        m_event.threadId = traceThreadId();
+    }
+
+    void finish()
+    {
+        // The sink might have been unset meanwhile
+        if (!m_sink || TraceSink::current() != m_sink)
+            return;
+
+        m_event.durationUs = traceTimestampUs() - m_event.timestampUs;
+        m_sink->addEvent(m_event);
+    }
+
+    TraceSink *const m_sink;
+    TraceEvent m_event;
+    KDDW_DELETE_COPY_CTOR(ScopedTraceEvent)
+};
+
+}
+
+#define KDDW_TRACE_CONCAT_IMPL(a, b) a##b
+#define KDDW_TRACE_CONCAT(a, b) KDDW_TRACE_CONCAT_IMPL(a, b)
+
+#define KDDW_SCOPED_TRACE(category, name) \
+    KDDockWidgets::ScopedTraceEvent KDDW_TRACE_CONCAT(kddwScopedTrace, __LINE__)(category, name)
+
+#define KDDW_SCOPED_TRACE_PHASES(category, firstPhaseName) \
+    KDDockWidgets::ScopedTraceEvent kddwTracePhases(category, firstPhaseName)
+
+#define KDDW_TRACE_PHASE(name) kddwTracePhases.nextPhase(name)
+
+#define KDDW_TRACE_INSTANT(category, name) KDDockWidgets::traceInstantEvent(category, name)
+
+#else
+
+#define KDDW_SCOPED_TRACE(category, name)
+#define KDDW_SCOPED_TRACE_PHASES(category, firstPhaseName)
+#define KDDW_TRACE_PHASE(name)
+#define KDDW_TRACE_INSTANT(category, name)
+
+#endif
@@ -462,6 +462,7 @@ bool View::equals(const View *one, const View *two)
 void View::installViewEventFilter(EventFilterInterface *filter)
 {
     d->m_viewEventFilters.push_back(filter);
+    onViewEventFilterInstalled();
 }
 
 void View::removeViewEventFilter(EventFilterInterface *filter)
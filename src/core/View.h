@@ -288,6 +288,12 @@ public:
     Private *const d;
 
 protected:
+    /// @brief Called after installViewEventFilter() added a filter
+    /// Frontends that only listen to native events while there are filters can start here
+    virtual void onViewEventFilterInstalled()
+    {
+    }
+
     Controller *const m_controller;
     bool m_inDtor = false;
 
@@ -105,6 +105,11 @@ int WidgetResizeHandler::widgetResizeHandlerMargin()
     return 4; // pixels
 }
 
+int WidgetResizeHandler::eventInterests() const
+{
+    return EventInterest_MouseButtonPress | EventInterest_MouseButtonRelease | EventInterest_MouseMove;
+}
+
 bool WidgetResizeHandler::onMouseEvent(View *widget, MouseEvent *e)
 {
     if (s_disableAllHandlers || !widget || !mTargetGuard)
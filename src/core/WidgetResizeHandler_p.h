@@ -166,6 +166,7 @@ public:
 
 private:
     // EventFilterInterface:
+    int eventInterests() const override;
     bool onMouseEvent(Core::View *, MouseEvent *) override;
     void setTarget(Core::View *w);
     bool mouseMoveEvent(MouseEvent *);
@@ -152,6 +152,11 @@ Vector<QString> WindowBeingDragged::affinities() const
     return m_floatingWindow ? m_floatingWindow->affinities() : Vector<QString>();
 }
 
+const AffinitySet &WindowBeingDragged::affinitySet() const
+{
+    return affinitySetOf(m_floatingWindow.data());
+}
+
 Size WindowBeingDragged::size() const
 {
     if (m_floatingWindow)
@@ -297,6 +302,18 @@ Vector<QString> WindowBeingDraggedWayland::affinities() const
     return {};
 }
 
+const AffinitySet &WindowBeingDraggedWayland::affinitySet() const
+{
+    if (m_floatingWindow)
+        return WindowBeingDragged::affinitySet();
+    else if (m_group)
+        return affinitySetOf(m_group.data());
+    else if (m_dockWidget)
+        return affinitySetOf(m_dockWidget.data());
+
+    return AffinitySet::emptySet();
+}
+
 Vector<DockWidget *> WindowBeingDraggedWayland::dockWidgets() const
 {
     if (m_floatingWindow)
@@ -16,6 +16,7 @@
 #include "core/View.h"
 #include "core/ViewGuard.h"
 #include "core/ObjectGuard_p.h"
+#include "core/AffinitySet_p.h"
 
 namespace KDDockWidgets {
 
@@ -54,6 +55,10 @@ public:
     ///@brief returns the affinities of the window being dragged
     virtual Vector<QString> affinities() const;
 
+    /// @brief returns the interned affinities of the window being dragged
+    /// Cheaper than affinities(), used while hovering drop areas
+    virtual const AffinitySet &affinitySet() const;
+
     ///@brief size of the window being dragged contents
     virtual Size size() const;
 
@@ -105,6 +110,7 @@ public:
     Size maxSize() const override;
     Pixmap pixmap() const override;
     Vector<QString> affinities() const override;
+    const AffinitySet &affinitySet() const override;
     Vector<DockWidget *> dockWidgets() const override;
     bool isInWaylandDrag(Group *) const override;
 
@@ -16,16 +16,113 @@
 
 #include "core/DropArea.h"
 #include "core/DockRegistry.h"
+#include "core/DockRegistry_p.h"
 #include "core/Group.h"
+#include "core/Platform.h"
+#include "core/layouting/Item_p.h"
 
+#include "core/DelayedCall_p.h"
 #include "core/DragController_p.h"
 #include "core/Logging_p.h"
+#include "core/ObjectGuard_p.h"
 #include "core/Utils_p.h"
+#include "core/WindowBeingDragged_p.h"
+
+#include <kdbindings/signal.h>
+
+#include <vector>
 
 
 using namespace KDDockWidgets;
 using namespace KDDockWidgets::Core;
 
+namespace KDDockWidgets::Core {
+
+class ClassicDropIndicatorOverlay::Private
+{
+public:
+    /// A rect returned by DropArea::rectForDrop(), along with everything it depends on.
+    /// The layout it depends on isn't part of the key, the whole cache is cleared when it changes.
+    /// Except for its size, which is compared instead, as watching the root's geometry would
+    /// require its rare signals.
+    struct CachedDropRect
+    {
+        Size layoutSize;
+        const Core::Item *relativeTo = nullptr;
+        KDDockWidgets::Location location = KDDockWidgets::Location_None;
+        Size size;
+        Size minSize;
+        Size maxSize;
+        Rect rect;
+    };
+
+    /// Computes the drop rects for the hovered group once the event loop is idle, so
+    /// the rubber band shows immediately when the user hovers an indicator.
+    class DelayedPrecomputeDropRects : public DelayedCall
+    {
+    public:
+        DelayedPrecomputeDropRects(ClassicDropIndicatorOverlay *overlay, Group *group)
+            : m_overlay(overlay)
+            , m_group(group)
+        {
+        }
+
+        void call() override
+        {
+            if (m_overlay && m_group && m_overlay->isHovered()
+                && m_overlay->hoveredGroup() == m_group.data())
+                m_overlay->precomputeDropRects(m_group);
+        }
+
+        KDDW_DELETE_COPY_CTOR(DelayedPrecomputeDropRects)
+    private:
+        const ObjectGuard<ClassicDropIndicatorOverlay> m_overlay;
+        const ObjectGuard<Group> m_group;
+    };
+
+    const CachedDropRect *cachedRect(Size layoutSize, const Core::Item *relativeTo,
+                                     KDDockWidgets::Location location, Size size, Size minSize,
+                                     Size maxSize) const
+    {
+        for (const CachedDropRect &cached : m_cachedRects) {
+            if (cached.layoutSize == layoutSize && cached.relativeTo == relativeTo
+                && cached.location == location
+                && cached.size == size && cached.minSize == minSize && cached.maxSize == maxSize)
+                return &cached;
+        }
+
+        return nullptr;
+    }
+
+    /// Starts tracking changes to @p dropArea's layout, which invalidate the cache
+    void watchLayout(Core::DropArea *dropArea)
+    {
+        auto clear = [this] { clearCache(); };
+        Core::ItemBoxContainer *root = dropArea->rootItem();
+        m_layoutChangedConnection = DockRegistry::self()->dptr()->layoutChanged.connect(clear);
+        m_rootNumItemsConnection = root->numItemsChanged.connect(clear);
+        m_rootMinSizeConnection = root->minSizeChanged.connect(clear);
+        m_rootNumVisibleItemsConnection = root->numVisibleItemsChanged.connect(clear);
+    }
+
+    void clearCache()
+    {
+        m_cachedRects.clear();
+        m_layoutChangedConnection = KDBindings::ScopedConnection();
+        m_rootNumItemsConnection = KDBindings::ScopedConnection();
+        m_rootMinSizeConnection = KDBindings::ScopedConnection();
+        m_rootNumVisibleItemsConnection = KDBindings::ScopedConnection();
+    }
+
+    std::vector<CachedDropRect> m_cachedRects;
+    KDBindings::ScopedConnection m_layoutChangedConnection;
+    KDBindings::ScopedConnection m_rootNumItemsConnection;
+    KDBindings::ScopedConnection m_rootMinSizeConnection;
+    KDBindings::ScopedConnection m_rootNumVisibleItemsConnection;
+};
+
+}
+
 static Core::ClassicIndicatorWindowViewInterface *
 createIndicatorWindow(ClassicDropIndicatorOverlay *classicIndicators, Core::View *parent)
 {
@@ -40,6 +137,7 @@ ClassicDropIndicatorOverlay::ClassicDropIndicatorOverlay(Core::DropArea *dropAre
     , m_rubberBand(Config::self().viewFactory()->createRubberBand(
           rubberBandIsTopLevel() ? nullptr : dropArea->view())) // rubber band is parented on the drop area
     , m_indicatorWindow(createIndicatorWindow(this, dropArea->view())) // a real top-level, transparent window, to hold our indicators
+    , d(new Private())
 {
     if (rubberBandIsTopLevel())
         m_rubberBand->setWindowOpacity(0.5);
@@ -49,6 +147,7 @@ ClassicDropIndicatorOverlay::ClassicDropIndicatorOverlay(Core::DropArea *dropAre
 ClassicDropIndicatorOverlay::~ClassicDropIndicatorOverlay()
 {
     delete m_indicatorWindow;
+    delete d;
 }
 
 DropLocation ClassicDropIndicatorOverlay::hover_impl(Point globalPos)
@@ -77,6 +176,9 @@ void ClassicDropIndicatorOverlay::updateVisibility()
     } else {
         m_rubberBand->setVisible(false);
         m_indicatorWindow->setVisible(false);
+
+        // The drag left this drop area or ended, the cached rects are only valid during a drag
+        d->clearCache();
     }
 
     m_indicatorWindow->updateIndicatorVisibility();
@@ -137,7 +239,6 @@ void ClassicDropIndicatorOverlay::setCurrentDropLocation(DropLocation location)
         return;
     }
 
-    KDDockWidgets::Location multisplitterLocation = locationToMultisplitterLocation(location);
     Core::Group *relativeToFrame = nullptr;
 
     switch (location) {
@@ -161,10 +262,7 @@ void ClassicDropIndicatorOverlay::setCurrentDropLocation(DropLocation location)
         break;
     }
 
-    auto windowBeingDragged = DragController::instance()->windowBeingDragged();
-
-    Rect rect = m_dropArea->rectForDrop(windowBeingDragged, multisplitterLocation,
-                                        m_dropArea->itemForGroup(relativeToFrame));
+    const Rect rect = rectForDrop(location, relativeToFrame);
 
     m_rubberBand->setGeometry(geometryForRubberband(rect));
     m_rubberBand->setVisible(true);
@@ -174,6 +272,51 @@ void ClassicDropIndicatorOverlay::setCurrentDropLocation(DropLocation location)
     }
 }
 
+Rect ClassicDropIndicatorOverlay::rectForDrop(DropLocation location, Group *relativeTo)
+{
+    // Computing the rect means simulating the drop on a copy of the layout, so cache it while dragging.
+    // Hovering back and forth between the same indicators is then free.
+
+    auto windowBeingDragged = DragController::instance()->windowBeingDragged();
+    if (!windowBeingDragged)
+        return {};
+
+    const KDDockWidgets::Location multisplitterLocation = locationToMultisplitterLocation(location);
+    const Core::Item *relativeToItem = m_dropArea->itemForGroup(relativeTo);
+    const Size size = windowBeingDragged->size();
+    const Size minSize = windowBeingDragged->minSize();
+    const Size maxSize = windowBeingDragged->maxSize();
+
+    const Size layoutSize = m_dropArea->layoutSize();
+    if (auto cached = d->cachedRect(layoutSize, relativeToItem, multisplitterLocation, size, minSize, maxSize))
+        return cached->rect;
+
+    if (d->m_cachedRects.empty())
+        d->watchLayout(m_dropArea);
+
+    const Rect rect = m_dropArea->rectForDrop(windowBeingDragged, multisplitterLocation, relativeToItem);
+    d->m_cachedRects.push_back({ layoutSize, relativeToItem, multisplitterLocation, size, minSize, maxSize, rect });
+
+    return rect;
+}
+
+void ClassicDropIndicatorOverlay::precomputeDropRects(Group *group)
+{
+    for (auto loc : { DropLocation_Left, DropLocation_Top, DropLocation_Right, DropLocation_Bottom })
+        rectForDrop(loc, group);
+
+    // These don't depend on the hovered group, so are only computed once per drag
+    for (auto loc : { DropLocation_OutterLeft, DropLocation_OutterTop, DropLocation_OutterRight,
+                      DropLocation_OutterBottom })
+        rectForDrop(loc, nullptr);
+}
+
+void ClassicDropIndicatorOverlay::onHoveredGroupChanged(Group *group)
+{
+    if (group && isHovered())
+        Platform::instance()->runDelayed(0, new Private::DelayedPrecomputeDropRects(this, group));
+}
+
 void ClassicDropIndicatorOverlay::updateWindowPosition()
 {
     Rect rect = this->rect();
@@ -37,8 +37,15 @@ public:
     Core::ClassicIndicatorWindowViewInterface *indicatorWindow() const;
     View *rubberBand() const;
 
+    class Private;
+
+protected:
+    void onHoveredGroupChanged(Group *) override;
+
 private:
     friend class KDDockWidgets::Indicator;
+    Rect rectForDrop(DropLocation, Group *relativeTo);
+    void precomputeDropRects(Group *);
     bool rubberBandIsTopLevel() const;
     void raiseIndicators();
     Rect geometryForRubberband(Rect localRect) const;
@@ -46,6 +53,7 @@ private:
 
     View *const m_rubberBand;
     Core::ClassicIndicatorWindowViewInterface *const m_indicatorWindow;
+    Private *const d;
 };
 
 }
@@ -0,0 +1,132 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "Allocators_p.h"
+
+#include <algorithm>
+#include <new>
+
+using namespace KDDockWidgets::Core;
+
+PoolAllocator *PoolAllocator::self()
+{
+    // Intentionally leaked, as items might still be deleted during static destruction
+    static auto pool = new PoolAllocator();
+    return pool;
+}
+
+void *PoolAllocator::allocate(size_t size)
+{
+    if (size == 0 || size > MaxBlockSize)
+        return ::operator new(size);
+
+    const size_t bucket = (size - 1) / Granularity;
+    const size_t blockSize = (bucket + 1) * Granularity;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FreeBlock *&freeList = m_freeLists[bucket];
+    if (!freeList) {
+        // Carve a new chunk into blocks and add them all to the free list
+        const size_t chunkSize = blockSize * BlocksPerChunk;
+        m_chunks.push_back(std::make_unique<char[]>(chunkSize));
+        m_reservedBytes += chunkSize;
+
+        char *chunk = m_chunks.back().get();
+        for (size_t i = BlocksPerChunk; i > 0; --i) {
+            auto block = reinterpret_cast<FreeBlock *>(chunk + (i - 1) * blockSize);
+            block->next = freeList;
+            freeList = block;
+        }
+    }
+
+    FreeBlock *block = freeList;
+    freeList = block->next;
+    ++m_numAllocatedBlocks;
+
+    return block;
+}
+
+void PoolAllocator::deallocate(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size == 0 || size > MaxBlockSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    const size_t bucket = (size - 1) / Granularity;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto block = static_cast<FreeBlock *>(ptr);
+    block->next = m_freeLists[bucket];
+    m_freeLists[bucket] = block;
+    --m_numAllocatedBlocks;
+}
+
+size_t PoolAllocator::numAllocatedBlocks() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numAllocatedBlocks;
+}
+
+size_t PoolAllocator::reservedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_reservedBytes;
+}
+
+ScratchBuffer &ScratchBuffer::forCurrentThread()
+{
+    static thread_local ScratchBuffer buffer;
+    return buffer;
+}
+
+ScratchBuffer::Scope::Scope()
+    : m_block(forCurrentThread().m_currentBlock)
+    , m_offset(forCurrentThread().m_offset)
+{
+}
+
+ScratchBuffer::Scope::~Scope()
+{
+    ScratchBuffer &buffer = forCurrentThread();
+    buffer.m_currentBlock = m_block;
+    buffer.m_offset = m_offset;
+}
+
+int *ScratchBuffer::allocateInts(size_t count)
+{
+    ScratchBuffer &buffer = forCurrentThread();
+
+    const bool fits = buffer.m_currentBlock < buffer.m_blocks.size()
+        && buffer.m_offset + count <= buffer.m_blocks[buffer.m_currentBlock].size;
+
+    if (!fits) {
+        // Move to the next block. Blocks after the current one aren't in use by anyone, as scopes
+        // are nested, so if the next one is too small it can simply be replaced by a bigger one.
+        const size_t next = buffer.m_blocks.empty() ? 0 : buffer.m_currentBlock + 1;
+        if (next >= buffer.m_blocks.size() || buffer.m_blocks[next].size < count) {
+            const size_t previousSize = buffer.m_blocks.empty() ? 0 : buffer.m_blocks.back().size;
+            const size_t size = std::max({ count, previousSize * 2, size_t(1024) });
+            buffer.m_blocks.resize(next);
+            buffer.m_blocks.push_back({ std::make_unique<int[]>(size), size });
+        }
+
+        buffer.m_currentBlock = next;
+        buffer.m_offset = 0;
+    }
+
+    int *result = buffer.m_blocks[buffer.m_currentBlock].data.get() + buffer.m_offset;
+    buffer.m_offset += count;
+    return result;
+}
@@ -0,0 +1,109 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "kddockwidgets/docks_export.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace KDDockWidgets::Core {
+
+/// Serves small allocations of a few fixed sizes out of big chunks.
+///
+/// Building or restoring a big layout creates thousands of Items, each with a Private. Taking them
+/// from a pool means a few big allocations instead of thousands of small ones, and neighbouring
+/// items end up close in memory.
+///
+/// Freed blocks are recycled for the next allocation of the same size, memory isn't returned to the
+/// system. The pool is thus as big as the highest number of items alive at the same time.
+class DOCKS_EXPORT_FOR_UNIT_TESTS PoolAllocator
+{
+public:
+    static PoolAllocator *self();
+
+    /// Returns a block of at least @p size bytes. Falls back to ::operator new for big sizes.
+    void *allocate(size_t size);
+
+    /// Returns a block to the pool. @p size must be the same size passed to allocate().
+    void deallocate(void *ptr, size_t size);
+
+    /// Returns how many blocks are currently handed out
+    size_t numAllocatedBlocks() const;
+
+    /// Returns how many bytes were reserved from the system, in chunks
+    size_t reservedBytes() const;
+
+private:
+    PoolAllocator() = default;
+
+    static constexpr size_t Granularity = 16;
+    static constexpr size_t MaxBlockSize = 1024;
+    static constexpr size_t BlocksPerChunk = 64;
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    mutable std::mutex m_mutex;
+    std::array<FreeBlock *, MaxBlockSize / Granularity> m_freeLists = {};
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    size_t m_numAllocatedBlocks = 0;
+    size_t m_reservedBytes = 0;
+};
+
+/// A per-thread bump allocator for short lived int buffers needed while layouting, such as the
+/// arrays used by SizingKernels.
+///
+/// Allocating is just moving a pointer. Memory is reclaimed when the enclosing Scope ends, and reused
+/// by the next layouting pass, so a resize doesn't hit the heap at all once warmed up.
+class DOCKS_EXPORT_FOR_UNIT_TESTS ScratchBuffer
+{
+public:
+    /// Everything allocated while a Scope is alive is released when it's destroyed.
+    /// Scopes must be nested, like stack frames.
+    class DOCKS_EXPORT_FOR_UNIT_TESTS Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const size_t m_block;
+        const size_t m_offset;
+    };
+
+    /// Returns an uninitialized buffer of @p count ints, valid until the current Scope ends
+    static int *allocateInts(size_t count);
+
+private:
+    static ScratchBuffer &forCurrentThread();
+
+    struct Block
+    {
+        std::unique_ptr<int[]> data;
+        size_t size = 0;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_currentBlock = 0;
+    size_t m_offset = 0;
+};
+
+}
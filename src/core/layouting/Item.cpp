@@ -14,10 +14,13 @@
 #include "LayoutingHost_p.h"
 #include "LayoutingGuest_p.h"
 #include "LayoutingSeparator_p.h"
+#include "Allocators_p.h"
+#include "SizingKernels_p.h"
 
 #include "core/Logging_p.h"
 #include "core/ObjectGuard_p.h"
 #include "core/ScopedValueRollback_p.h"
+#include "core/Tracing_p.h"
 #include "core/nlohmann_helpers_p.h"
 
 #include <algorithm>
@@ -52,6 +55,8 @@ int Core::Item::layoutSpacing = 5;
 bool Core::Item::s_silenceSanityChecks = false;
 
 DumpScreenInfoFunc Core::Item::s_dumpScreenInfoFunc = nullptr;
+std::atomic<int> Core::Item::s_numItemsWithRareSignals = 0;
+uint64_t Core::Item::s_lastHiddenSerial = 0;
 CreateSeparatorFunc Core::Item::s_createSeparatorFunc = nullptr;
 
 // There are the defaults. They can be changed by the user via Config.h API.
@@ -249,7 +254,7 @@ void Item::setGuest(LayoutingGuest *guest)
 
 void Item::updateWidgetGeometries()
 {
-    if (m_guest) {
+    if (m_guest && !isInBatch()) {
         m_guest->setGeometry(mapToRoot(rect()));
     }
 }
@@ -281,6 +286,14 @@ void Item::fillFromJson(const nlohmann::json &j,
     }
 }
 
+void Item::fillFromItem(const Item *other)
+{
+    // Same as what to_json() + fillFromJson() would copy
+    m_sizingInfo = other->m_sizingInfo;
+    m_sizingInfo.isBeingInserted = false;
+    m_isVisible = other->m_isVisible;
+}
+
 Item *Item::createFromJson(LayoutingHost *hostWidget, ItemContainer *parent, const nlohmann::json &json,
                            const std::unordered_map<QString, LayoutingGuest *> &widgets)
 {
@@ -533,7 +546,8 @@ void Item::setMaxSizeHint(Size sz)
 {
     if (sz != m_sizingInfo.maxSizeHint) {
         m_sizingInfo.maxSizeHint = sz;
-        maxSizeChanged.emit(this);
+        if (m_rareSignals)
+            m_rareSignals->maxSizeChanged.emit(this);
     }
 }
 
@@ -809,6 +823,8 @@ void Item::setIsVisible(bool is)
 {
     if (is != m_isVisible) {
         m_isVisible = is;
+        if (!is)
+            m_hiddenSerial = ++s_lastHiddenSerial;
         visibleChanged.emit(this, is);
     }
 
@@ -898,16 +914,19 @@ void Item::setGeometry(Rect rect)
             KDDW_ERROR("Constraints not honoured. this={}, sz={}, min={}, parent={}", ( void * )this, rect.size(), minSz, ( void * )parentContainer());
         }
 
-        geometryChanged.emit();
+        if (m_rareSignals) {
+            m_rareSignals->geometryChanged.emit();
+            m_rareSignals->geometryDelta.emit(oldGeo, rect);
+            if (oldGeo.width() != width())
+                m_rareSignals->widthChanged.emit();
+            if (oldGeo.height() != height())
+                m_rareSignals->heightChanged.emit();
+        }
 
-        if (oldGeo.x() != x())
-            xChanged.emit();
-        if (oldGeo.y() != y())
-            yChanged.emit();
-        if (oldGeo.width() != width())
-            widthChanged.emit();
-        if (oldGeo.height() != height())
-            heightChanged.emit();
+        const bool xChanged = oldGeo.x() != x();
+        const bool yChanged = oldGeo.y() != y();
+        if ((xChanged || yChanged) && s_numItemsWithRareSignals > 0)
+            emitPositionChanged_recursive(xChanged, yChanged);
 
         updateWidgetGeometries();
     }
@@ -942,6 +961,16 @@ void Item::dumpLayout(int level, bool)
     std::cerr << "\n";
 }
 
+void *Item::operator new(size_t size)
+{
+    return PoolAllocator::self()->allocate(size);
+}
+
+void Item::operator delete(void *ptr, size_t size)
+{
+    PoolAllocator::self()->deallocate(ptr, size);
+}
+
 Item::Item(LayoutingHost *hostWidget, ItemContainer *parent)
     : Core::Object(parent)
     , m_isContainer(false)
@@ -963,13 +992,43 @@ Item::Item(bool isContainer, LayoutingHost *hostWidget, ItemContainer *parent)
 Item::~Item()
 {
     m_inDtor = true;
-    safeEmitSignal(aboutToBeDeleted);
+    if (m_rareSignals)
+        safeEmitSignal(m_rareSignals->aboutToBeDeleted);
 
     m_minSizeChangedHandle.disconnect();
     m_visibleChangedHandle.disconnect();
     m_parentChangedConnection.disconnect();
 
     safeEmitSignal(deleted);
+
+    if (m_rareSignals)
+        s_numItemsWithRareSignals--;
+}
+
+Item::RareSignals &Item::rareSignals()
+{
+    if (!m_rareSignals) {
+        m_rareSignals = std::make_unique<RareSignals>();
+        s_numItemsWithRareSignals++;
+    }
+
+    return *m_rareSignals;
+}
+
+void Item::emitPositionChanged_recursive(bool xChanged, bool yChanged)
+{
+    if (!m_rareSignals)
+        return;
+
+    if (xChanged)
+        m_rareSignals->xChanged.emit();
+    if (yChanged)
+        m_rareSignals->yChanged.emit();
+}
+
+uint64_t Item::hiddenSerial() const
+{
+    return m_hiddenSerial;
 }
 
 void Item::turnIntoPlaceholder()
@@ -1096,6 +1155,16 @@ int Item::visibleCount_recursive() const
 
 struct ItemBoxContainer::Private
 {
+    static void *operator new(size_t size)
+    {
+        return PoolAllocator::self()->allocate(size);
+    }
+
+    static void operator delete(void *ptr, size_t size)
+    {
+        PoolAllocator::self()->deallocate(ptr, size);
+    }
+
     explicit Private(ItemBoxContainer *qq)
         : q(qq)
     {
@@ -1118,6 +1187,9 @@ struct ItemBoxContainer::Private
     int defaultLengthFor(Item *item, const InitialOption &option) const;
 
     void relayoutIfNeeded();
+
+    /// Called once the children were filled from json or from another item
+    void onDeserialized();
     const Item *itemFromPath(const Vector<int> &path) const;
     void resizeChildren(Size oldSize, Size newSize, SizingInfo::List &sizes,
                         ChildrenResizeStrategy);
@@ -1138,15 +1210,23 @@ struct ItemBoxContainer::Private
     bool isDummy() const;
     void deleteSeparators_recursive();
     void updateSeparators_recursive();
+    void copyGeometries_recursive(const ItemBoxContainer *other);
     Size minSize(const Item::List &items) const;
     int excessLength() const;
 
+    /// These are deferred to endBatch() while a batch is open. Only called on the root.
+    void emitNumItemsChanged();
+    void emitNumVisibleItemsChanged();
+
     mutable bool m_checkSanityScheduled = false;
     Vector<LayoutingSeparator *> m_separators;
     bool m_convertingItemToContainer = false;
     bool m_blockUpdatePercentages = false;
     bool m_isDeserializing = false;
     bool m_isSimplifying = false;
+    int m_batchDepth = 0;
+    bool m_numItemsChangedInBatch = false;
+    bool m_numVisibleItemsChangedInBatch = false;
     Qt::Orientation m_orientation = Qt::Vertical;
     ItemBoxContainer *const q;
 };
@@ -1312,6 +1392,11 @@ bool ItemBoxContainer::checkSanity()
         }
     }
 
+    if (isInBatch()) {
+        // Separators are only created and positioned once the batch ends, see beginBatch()
+        return true;
+    }
+
     const auto numVisibleChildren = int(visibleChildren.size());
     if (d->m_separators.size() != std::max(0, numVisibleChildren - 1)) {
         root()->dumpLayout();
@@ -1413,6 +1498,7 @@ void ItemBoxContainer::restore(Item *child)
 
 void ItemBoxContainer::removeItem(Item *item, bool hardRemove)
 {
+    KDDW_SCOPED_TRACE("layouting", "ItemBoxContainer::removeItem");
     assert(!item->isRoot());
 
     if (!contains(item)) {
@@ -1438,7 +1524,7 @@ void ItemBoxContainer::removeItem(Item *item, bool hardRemove)
         m_children.removeOne(item);
         delete item;
         if (!isContainer)
-            root()->numItemsChanged.emit();
+            root()->d->emitNumItemsChanged();
     } else {
         item->setIsVisible(false);
         item->setGuest(nullptr);
@@ -1450,7 +1536,7 @@ void ItemBoxContainer::removeItem(Item *item, bool hardRemove)
     }
 
     if (wasVisible) {
-        root()->numVisibleItemsChanged.emit(root()->numVisibleChildren());
+        root()->d->emitNumVisibleItemsChanged();
     }
 
     if (isEmpty()) {
@@ -1551,6 +1637,7 @@ void ItemBoxContainer::insertItemRelativeTo(Item *item, Item *relativeTo, Locati
 void ItemBoxContainer::insertItem(Item *item, Location loc,
                                   const KDDockWidgets::InitialOption &initialOption)
 {
+    KDDW_SCOPED_TRACE("layouting", "ItemBoxContainer::insertItem");
     assert(item != this);
     if (contains(item)) {
         KDDW_ERROR("Item already exists");
@@ -1692,19 +1779,17 @@ Rect ItemBoxContainer::suggestedDropRect(const Item *item, const Item *relativeT
     if (windowNeedsGrowing)
         return suggestedDropRectFallback(item, relativeTo, loc);
 
-    nlohmann::json rootSerialized;
-    root()->to_json(rootSerialized);
-
+    // This runs on every drop location change while dragging, so copy the tree directly
+    // instead of going through json
     ItemBoxContainer rootCopy(nullptr);
-    rootCopy.fillFromJson(rootSerialized, {});
+    rootCopy.fillFromItem(root());
 
     if (relativeTo)
         relativeTo = rootCopy.d->itemFromPath(relativeTo->pathFromRoot());
 
-    nlohmann::json itemSerialized;
-    item->to_json(itemSerialized);
+    // Only the item's own sizing info matters, even if it's a container
     auto itemCopy = new Item(nullptr);
-    itemCopy->fillFromJson(itemSerialized, {});
+    itemCopy->Item::fillFromItem(item);
 
     const InitialOption opt = DefaultSizeMode::FairButFloor;
     if (relativeTo) {
@@ -1978,8 +2063,8 @@ void ItemBoxContainer::insertItem(Item *item, int index, const InitialOption &op
         simplify();
 
     if (shouldEmitVisibleChanged)
-        root()->numVisibleItemsChanged.emit(root()->numVisibleChildren());
-    root()->numItemsChanged.emit();
+        root()->d->emitNumVisibleItemsChanged();
+    root()->d->emitNumItemsChanged();
 }
 
 bool ItemBoxContainer::hasOrientationFor(Location loc) const
@@ -2236,90 +2321,9 @@ void ItemBoxContainer::Private::honourMaxSizes(SizingInfo::List &sizes)
     // Reduces the size of all children that are bigger than max-size.
     // Assuming there's widgets that are willing to grow to occupy that space.
 
-    int amountNeededToShrink = 0;
-    int amountAvailableToGrow = 0;
-    Vector<int> indexesOfShrinkers;
-    Vector<int> indexesOfGrowers;
-
-    for (int i = 0; i < sizes.count(); ++i) {
-        SizingInfo &info = sizes[i];
-        const int neededToShrink = info.neededToShrink(m_orientation);
-        const int availableToGrow = info.availableToGrow(m_orientation);
-
-        if (neededToShrink > 0) {
-            amountNeededToShrink += neededToShrink;
-            indexesOfShrinkers.push_back(i); // clazy:exclude=reserve-candidates
-        } else if (availableToGrow > 0) {
-            amountAvailableToGrow = std::min(amountAvailableToGrow + availableToGrow, q->length());
-            indexesOfGrowers.push_back(i); // clazy:exclude=reserve-candidates
-        }
-    }
-
-    // Don't grow more than what's needed
-    amountAvailableToGrow = std::min(amountNeededToShrink, amountAvailableToGrow);
-
-    // Don't shrink more than what's available to grow
-    amountNeededToShrink = std::min(amountAvailableToGrow, amountNeededToShrink);
-
-    if (amountNeededToShrink == 0 || amountAvailableToGrow == 0)
-        return;
-
-    // We gathered who needs to shrink and who can grow, now try to do it evenly so that all
-    // growers participate, and not just one giving everything.
-
-    // Do the growing:
-    while (amountAvailableToGrow > 0) {
-        // Each grower will grow a bit (round-robin)
-        auto toGrow = std::max(1, amountAvailableToGrow / int(indexesOfGrowers.size()));
-
-        // TODO: Use cbegin/cend once we drop Qt 5
-        for (auto it = indexesOfGrowers.begin(); it != indexesOfGrowers.end();) {
-            const int index = *it;
-            SizingInfo &sizing = sizes[index];
-            const auto grew = std::min(sizing.availableToGrow(m_orientation), toGrow);
-            sizing.incrementLength(grew, m_orientation);
-            amountAvailableToGrow -= grew;
-
-            if (amountAvailableToGrow == 0) {
-                // We're done growing
-                break;
-            }
-
-            if (sizing.availableToGrow(m_orientation) == 0) {
-                // It's no longer a grower
-                it = indexesOfGrowers.erase(it); // clazy:exclude=strict-iterators
-            } else {
-                it++;
-            }
-        }
-    }
-
-    // Do the shrinking:
-    while (amountNeededToShrink > 0) {
-        // Each shrinker will shrink a bit (round-robin)
-        auto toShrink = std::max(1, amountNeededToShrink / int(indexesOfShrinkers.size()));
-
-        // TODO: Use cbegin/cend once we drop Qt 5
-        for (auto it = indexesOfShrinkers.begin(); it != indexesOfShrinkers.end();) {
-            const int index = *it;
-            SizingInfo &sizing = sizes[index];
-            const auto shrunk = std::min(sizing.neededToShrink(m_orientation), toShrink);
-            sizing.incrementLength(-shrunk, m_orientation);
-            amountNeededToShrink -= shrunk;
-
-            if (amountNeededToShrink == 0) {
-                // We're done shrinking
-                break;
-            }
-
-            if (sizing.neededToShrink(m_orientation) == 0) {
-                // It's no longer a shrinker
-                it = indexesOfShrinkers.erase(it); // clazy:exclude=strict-iterators
-            } else {
-                it++;
-            }
-        }
-    }
+    SizingArrays arrays(sizes, m_orientation);
+    SizingKernels::honourMaxSizes(arrays, q->length());
+    arrays.applyLengths(sizes);
 }
 
 bool ItemBoxContainer::hostSupportsHonouringLayoutMinSize() const
@@ -2334,6 +2338,7 @@ bool ItemBoxContainer::hostSupportsHonouringLayoutMinSize() const
 
 void ItemBoxContainer::setSize_recursive(Size newSize, ChildrenResizeStrategy strategy)
 {
+    KDDW_SCOPED_TRACE("layouting", "ItemBoxContainer::setSize_recursive");
     ScopedValueRollback block(d->m_blockUpdatePercentages, true);
 
     const Size minSize = this->minSize();
@@ -2715,78 +2720,13 @@ void ItemBoxContainer::layoutEqually()
 
 void ItemBoxContainer::layoutEqually(SizingInfo::List &sizes)
 {
-    const auto numItems = sizes.count();
-    Vector<int> satisfiedIndexes;
-    satisfiedIndexes.reserve(numItems);
-
-    int lengthToGive = length() - (d->m_separators.size() * Item::layoutSpacing);
-
-    // clear the sizes before we start distributing
-    for (SizingInfo &size : sizes) {
-        size.setLength(0, d->m_orientation);
-    }
+    // Not using m_separators, as copies of the layout without host don't have any
+    const int numSeparators = std::max(0, numVisibleChildren() - 1);
+    const int lengthToGive = length() - (numSeparators * Item::layoutSpacing);
 
-    while (satisfiedIndexes.count() < sizes.count()) {
-        const int remainingItems = int(sizes.count() - satisfiedIndexes.count());
-        const int suggestedToGive = std::max(1, lengthToGive / remainingItems);
-        const auto oldLengthToGive = lengthToGive;
-
-        for (int i = 0; i < numItems; ++i) {
-            if (satisfiedIndexes.contains(i))
-                continue;
-
-            SizingInfo &size = sizes[i];
-            if (size.availableToGrow(d->m_orientation) <= 0) {
-                // Was already satisfied from the beginning
-                satisfiedIndexes.push_back(i);
-                continue;
-            }
-
-            // Bound the max length. Our max can't be bigger than the remaining space.
-            // The layout's min length minus our own min length is the amount of space that we
-            // need to guarantee. We can't go larger and overwrite that
-
-            const auto othersMissing = // The size that the others are missing to satisfy their
-                                       // minimum length
-                std::accumulate(sizes.constBegin(), sizes.constEnd(), 0,
-                                [this](size_t sum, const SizingInfo &sz) {
-                                    return int(sum) + sz.missingLength(d->m_orientation);
-                                })
-                - size.missingLength(d->m_orientation);
-
-            const auto maxLength =
-                std::min(size.length(d->m_orientation) + lengthToGive - othersMissing,
-                         size.maxLengthHint(d->m_orientation));
-
-            const auto newItemLenght =
-                bound(size.minLength(d->m_orientation),
-                      size.length(d->m_orientation) + suggestedToGive, maxLength);
-            const auto toGive = newItemLenght - size.length(d->m_orientation);
-
-            if (toGive == 0) {
-                assert(false);
-                satisfiedIndexes.push_back(i);
-            } else {
-                lengthToGive -= toGive;
-                size.incrementLength(toGive, d->m_orientation);
-                if (size.availableToGrow(d->m_orientation) <= 0) {
-                    satisfiedIndexes.push_back(i);
-                }
-                if (lengthToGive == 0)
-                    return;
-
-                if (lengthToGive < 0) {
-                    KDDW_ERROR("Breaking infinite loop");
-                    return;
-                }
-            }
-        }
-
-        if (oldLengthToGive == lengthToGive) {
-            // Nothing happened, we can't satisfy more items, due to min/max constraints
-            return;
-        }
-    }
+    SizingArrays arrays(sizes, d->m_orientation);
+    SizingKernels::layoutEqually(arrays, lengthToGive);
+    arrays.applyLengths(sizes);
 }
 
 void ItemBoxContainer::layoutEqually_recursive()
@@ -2800,6 +2740,29 @@ void ItemBoxContainer::layoutEqually_recursive()
     }
 }
 
+void ItemBoxContainer::copyGeometriesFrom(const ItemBoxContainer *other)
+{
+    // Percentages were already calculated by other, just copy them
+    ScopedValueRollback blockPercentages(root()->d->m_blockUpdatePercentages, true);
+
+    setGeometry(other->geometry());
+    d->copyGeometries_recursive(other);
+    d->updateSeparators_recursive();
+}
+
+void ItemBoxContainer::Private::copyGeometries_recursive(const ItemBoxContainer *other)
+{
+    const auto count = q->m_children.size();
+    for (int i = 0; i < count; ++i) {
+        Item *child = q->m_children.at(i);
+        const Item *otherChild = other->m_children.at(i);
+        child->m_sizingInfo.percentageWithinParent = otherChild->m_sizingInfo.percentageWithinParent;
+        child->setGeometry(otherChild->geometry());
+        if (auto c = child->asBoxContainer())
+            c->d->copyGeometries_recursive(object_cast<const ItemBoxContainer *>(otherChild));
+    }
+}
+
 Item *ItemBoxContainer::visibleNeighbourFor(const Item *item, Side side) const
 {
     // Item might not be visible, so use m_children instead of visibleChildren()
@@ -3259,49 +3222,14 @@ Vector<int> ItemBoxContainer::calculateSqueezes(
     squeezes.resize(count);
     std::fill(squeezes.begin(), squeezes.end(), 0);
 
-    int missing = needed;
-
-    if (strategy == NeighbourSqueezeStrategy::AllNeighbours) {
-        while (missing > 0) {
-            const int numDonors = int(std::count_if(availabilities.cbegin(), availabilities.cend(),
-                                                    [](int num) { return num > 0; }));
-
-            if (numDonors == 0) {
-                root()->dumpLayout();
-                assert(false);
-                return {};
-            }
-
-            int toTake = missing / numDonors;
-            if (toTake == 0)
-                toTake = missing;
-
-            for (int i = 0; i < count; ++i) {
-                const int available = availabilities.at(i);
-                if (available == 0)
-                    continue;
-                const int took = std::min({ missing, toTake, available });
-                availabilities[i] -= took;
-                missing -= took;
-                squeezes[i] += took;
-                if (missing == 0)
-                    break;
-            }
-        }
-    } else if (strategy == NeighbourSqueezeStrategy::ImmediateNeighboursFirst) {
-        for (int i = 0; i < count; i++) {
-            const auto index = reversed ? count - 1 - i : i;
-
-            const int available = availabilities.at(index);
-            if (available > 0) {
-                const int took = std::min(missing, available);
-                missing -= took;
-                squeezes[index] += took;
-            }
+    const int missing = SizingKernels::calculateSqueezes(availabilities.data(), squeezes.data(),
+                                                         int(count), needed, strategy, reversed);
 
-            if (missing == 0)
-                break;
-        }
+    if (missing > 0 && strategy == NeighbourSqueezeStrategy::AllNeighbours) {
+        // Not enough donors
+        root()->dumpLayout();
+        assert(false);
+        return {};
     }
 
     if (missing < 0) {
@@ -3367,8 +3295,13 @@ Vector<int> ItemBoxContainer::Private::requiredSeparatorPositions() const
 
 void ItemBoxContainer::Private::updateSeparators()
 {
-    if (!q->host())
+    if (!q->host() || q->isInBatch()) {
+        // A copy of the layout, like LayoutSolver's. Has no separators, but percentages
+        // should still be updated as in the real layout.
+        // Same while in a batch, endBatch() creates the separators.
+        q->updateChildPercentages();
         return;
+    }
 
     const Vector<int> positions = requiredSeparatorPositions();
     const auto requiredNumSeparators = positions.size();
@@ -3615,19 +3548,48 @@ void ItemBoxContainer::fillFromJson(const nlohmann::json &j,
         m_children.push_back(childItem);
     }
 
-    if (isRoot()) {
-        updateChildPercentages_recursive();
-        if (host()) {
-            d->updateSeparators_recursive();
-            d->updateWidgets_recursive();
+    d->onDeserialized();
+}
+
+void ItemBoxContainer::fillFromItem(const Item *other)
+{
+    auto otherContainer = object_cast<const ItemBoxContainer *>(other);
+    if (!otherContainer) {
+        KDDW_ERROR("Expected an ItemBoxContainer");
+        return;
+    }
+
+    ScopedValueRollback deserializing(d->m_isDeserializing, true);
+    Item::fillFromItem(other);
+
+    d->m_orientation = otherContainer->d->m_orientation;
+
+    m_children.reserve(otherContainer->m_children.size());
+    for (const Item *child : std::as_const(otherContainer->m_children)) {
+        Item *childItem =
+            child->isContainer() ? new ItemBoxContainer(host(), this) : new Item(host(), this);
+        childItem->fillFromItem(child);
+        m_children.push_back(childItem);
+    }
+
+    d->onDeserialized();
+}
+
+void ItemBoxContainer::Private::onDeserialized()
+{
+    if (q->isRoot()) {
+        q->updateChildPercentages_recursive();
+        if (q->host()) {
+            updateSeparators_recursive();
+            updateWidgets_recursive();
         }
 
-        d->relayoutIfNeeded();
-        positionItems_recursive();
+        relayoutIfNeeded();
+        q->positionItems_recursive();
 
-        minSizeChanged.emit(this);
+        q->minSizeChanged.emit(q);
 #ifdef DOCKS_DEVELOPER_MODE
-        if (!checkSanity())
+        if (!q->checkSanity())
             KDDW_ERROR("Resulting layout is invalid");
 #endif
     }
@@ -3921,6 +3883,59 @@ ItemBoxContainer::Private::neighbourSeparator_recursive(const Item *item, Side s
     return q->parentBoxContainer()->d->neighbourSeparator_recursive(q, side, orientation);
 }
 
+void ItemBoxContainer::Private::emitNumItemsChanged()
+{
+    if (m_batchDepth > 0)
+        m_numItemsChangedInBatch = true;
+    else
+        q->numItemsChanged.emit();
+}
+
+void ItemBoxContainer::Private::emitNumVisibleItemsChanged()
+{
+    if (m_batchDepth > 0)
+        m_numVisibleItemsChangedInBatch = true;
+    else
+        q->numVisibleItemsChanged.emit(q->numVisibleChildren());
+}
+
+bool Item::isInBatch() const
+{
+    // The root might be an ItemFreeContainer, which doesn't support batches
+    auto root = this->root();
+    return root && root->d->m_batchDepth > 0;
+}
+
+void ItemBoxContainer::beginBatch()
+{
+    root()->d->m_batchDepth++;
+}
+
+void ItemBoxContainer::endBatch()
+{
+    ItemBoxContainer *root = this->root();
+    if (root->d->m_batchDepth == 0) {
+        KDDW_ERROR("ItemBoxContainer::endBatch: No batch in progress");
+        return;
+    }
+
+    if (--root->d->m_batchDepth > 0)
+        return;
+
+    if (root->host()) {
+        root->d->updateSeparators_recursive();
+        root->d->updateWidgets_recursive();
+    }
+
+    if (std::exchange(root->d->m_numVisibleItemsChangedInBatch, false))
+        root->numVisibleItemsChanged.emit(root->numVisibleChildren());
+
+    if (std::exchange(root->d->m_numItemsChangedInBatch, false))
+        root->numItemsChanged.emit();
+
+    root->d->scheduleCheckSanity();
+}
+
 void ItemBoxContainer::Private::updateWidgets_recursive()
 {
     for (Item *item : std::as_const(q->m_children)) {
@@ -4031,6 +4046,16 @@ int ItemBoxContainer::Private::defaultLengthFor(Item *item, const InitialOption
 
 struct ItemContainer::Private
 {
+    static void *operator new(size_t size)
+    {
+        return PoolAllocator::self()->allocate(size);
+    }
+
+    static void operator delete(void *ptr, size_t size)
+    {
+        PoolAllocator::self()->deallocate(ptr, size);
+    }
+
     explicit Private(ItemContainer *qq)
         : q(qq)
     {
@@ -4046,17 +4071,6 @@ ItemContainer::ItemContainer(LayoutingHost *hostWidget, ItemContainer *parent)
     : Item(true, hostWidget, parent)
     , d(new Private(this))
 {
-    xChanged.connect([this] {
-        for (Item *item : std::as_const(m_children)) {
-            item->xChanged.emit();
-        }
-    });
-
-    yChanged.connect([this] {
-        for (Item *item : std::as_const(m_children)) {
-            item->yChanged.emit();
-        }
-    });
 }
 
 ItemContainer::ItemContainer(LayoutingHost *hostWidget)
@@ -4070,6 +4084,14 @@ ItemContainer::~ItemContainer()
     delete d;
 }
 
+void ItemContainer::emitPositionChanged_recursive(bool xChanged, bool yChanged)
+{
+    Item::emitPositionChanged_recursive(xChanged, yChanged);
+
+    for (Item *item : std::as_const(m_children))
+        item->emitPositionChanged_recursive(xChanged, yChanged);
+}
+
 Item::List ItemContainer::childItems() const
 {
     return m_children;
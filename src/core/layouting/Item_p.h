@@ -17,6 +17,8 @@
 #include "kdbindings/signal.h"
 #include "nlohmann/json.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 
@@ -190,6 +192,10 @@ public:
     explicit Item(KDDockWidgets::Core::LayoutingHost *hostWidget, ItemContainer *parent = nullptr);
     ~Item() override;
 
+    /// Items are allocated from PoolAllocator, as big layouts have thousands of them
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
     /// @brief returns whether this item is a root container
     bool isRoot() const;
 
@@ -253,6 +259,8 @@ public:
     bool isPlaceholder() const;
     void setGeometry(Rect rect);
     ItemBoxContainer *root() const;
+    /// Returns whether the layout is in a batch, see ItemBoxContainer::beginBatch()
+    bool isInBatch() const;
     Rect mapToRoot(Rect) const;
     Point mapToRoot(Point) const;
     int mapToRoot(int p, Qt::Orientation) const;
@@ -271,6 +279,10 @@ public:
     int refCount() const;
     void turnIntoPlaceholder();
 
+    /// Returns when this item last became hidden, as an ever increasing serial.
+    /// Used to find the least recently used placeholders.
+    uint64_t hiddenSerial() const;
+
     int minLength(Qt::Orientation) const;
     int maxLengthHint(Qt::Orientation) const;
 
@@ -301,6 +313,10 @@ public:
     virtual void fillFromJson(const nlohmann::json &,
                               const std::unordered_map<QString, LayoutingGuest *> &);
 
+    /// @brief Like fillFromJson() but copies directly from @p other, without a json round-trip.
+    /// Guests aren't copied, it's meant for filling dummy layouts used for simulations.
+    virtual void fillFromItem(const Item *other);
+
     static Item *createFromJson(LayoutingHost *hostWidget, ItemContainer *parent,
                                 const nlohmann::json &,
                                 const std::unordered_map<QString, LayoutingGuest *> &);
@@ -308,16 +324,38 @@ public:
     static void setDumpScreenInfoFunc(DumpScreenInfoFunc);
     static void setCreateSeparatorFunc(CreateSeparatorFunc);
 
-    KDBindings::Signal<> geometryChanged;
-    KDBindings::Signal<> xChanged;
-    KDBindings::Signal<> yChanged;
-    KDBindings::Signal<> widthChanged;
-    KDBindings::Signal<> heightChanged;
+    /// Signals which few items have connections to.
+    /// Allocated on first use, as big layouts have thousands of items, most of them placeholders.
+    struct RareSignals
+    {
+        KDBindings::Signal<> geometryChanged;
+        KDBindings::Signal<> xChanged;
+        KDBindings::Signal<> yChanged;
+        KDBindings::Signal<> widthChanged;
+        KDBindings::Signal<> heightChanged;
+
+        /// Emitted once per geometry change, with the old and new geometry.
+        /// Cheaper than connecting to the individual signals above.
+        KDBindings::Signal<Rect, Rect> geometryDelta;
+
+        KDBindings::Signal<Core::Item *> maxSizeChanged;
+        /// signal emitted when ~Item starts
+        KDBindings::Signal<> aboutToBeDeleted;
+    };
+
+    /// Returns the rare signals, allocating them if needed. Call this to connect to them.
+    RareSignals &rareSignals();
+
+    /// Returns whether rareSignals() was ever called. If not, there's nobody to notify.
+    bool hasRareSignals() const
+    {
+        return m_rareSignals != nullptr;
+    }
+
+    // Every item's parent connects to these, so they're always needed
     KDBindings::Signal<Core::Item *, bool> visibleChanged;
     KDBindings::Signal<Core::Item *> minSizeChanged;
-    KDBindings::Signal<Core::Item *> maxSizeChanged;
-    /// signal emitted when ~Item starts
-    KDBindings::Signal<> aboutToBeDeleted;
+    /// Positions connects to this for every placeholder
     KDBindings::Signal<> deleted;
 
 public:
@@ -336,6 +374,9 @@ public:
     Size missingSize() const;
     virtual void updateWidgetGeometries();
     virtual void setIsVisible(bool);
+    /// Emits xChanged/yChanged for this item and its descendants, whose position relative to
+    /// the root changes with ours
+    virtual void emitPositionChanged_recursive(bool xChanged, bool yChanged);
     bool isBeingInserted() const;
     void setBeingInserted(bool);
 
@@ -355,10 +396,17 @@ private:
     void onGuestDestroyed();
     bool m_isVisible = false;
     bool m_inSetSize = false;
+    uint64_t m_hiddenSerial = 0;
     LayoutingHost *m_host = nullptr;
     LayoutingGuest *m_guest = nullptr;
     static DumpScreenInfoFunc s_dumpScreenInfoFunc;
     static CreateSeparatorFunc s_createSeparatorFunc;
+    static uint64_t s_lastHiddenSerial;
+
+    std::unique_ptr<RareSignals> m_rareSignals;
+
+    /// Number of items with rare signals. While 0, geometry changes don't need to notify descendants.
+    static std::atomic<int> s_numItemsWithRareSignals;
 
     KDBindings::ConnectionHandle m_parentChangedConnection;
     KDBindings::ConnectionHandle m_minSizeChangedHandle;
@@ -397,6 +445,7 @@ public:
     int count_recursive() const;
     virtual void clear() = 0;
     bool inSetSize() const override;
+    void emitPositionChanged_recursive(bool xChanged, bool yChanged) override;
 
 public:
     KDBindings::Signal<> itemsChanged;
@@ -440,6 +489,11 @@ public:
     void requestEqualSize(LayoutingSeparator *separator);
     void layoutEqually();
     void layoutEqually_recursive();
+
+    /// Copies the geometries of @p other, which must be a copy of this tree, such as the one
+    /// used by LayoutSolver. Separators and guests are updated accordingly.
+    void copyGeometriesFrom(const ItemBoxContainer *other);
+
     void removeItem(Item *, bool hardRemove = true) override;
     Size minSize() const override;
     Size maxSizeHint() const override;
@@ -456,6 +510,7 @@ public:
     void to_json(nlohmann::json &) const override;
     void fillFromJson(const nlohmann::json &,
                       const std::unordered_map<QString, LayoutingGuest *> &) override;
+    void fillFromItem(const Item *other) override;
     void clear() override;
     Qt::Orientation orientation() const;
     bool isVertical() const;
@@ -465,6 +520,14 @@ public:
     bool isOverflowing() const;
     bool isDeserializing() const;
 
+    /// @brief Starts a batch of insertions and removals
+    /// While a batch is open the items are still sized, but separators, guest geometries and the
+    /// numItemsChanged/numVisibleItemsChanged signals are only updated once, in endBatch().
+    /// Applies to the whole tree, regardless of which container is called. Batches can be nested.
+    /// checkSanity() doesn't check the separators while in a batch.
+    void beginBatch();
+    void endBatch();
+
     /// @brief Returns the number of visible items layed-out horizontally or vertically
     /// But honours nesting
     int numSideBySide_recursive(Qt::Orientation) const;
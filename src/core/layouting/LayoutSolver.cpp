@@ -0,0 +1,114 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "LayoutSolver_p.h"
+#include "core/Logging_p.h"
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+namespace {
+
+void itemsPreOrder(Item *item, Item::List &result)
+{
+    result.push_back(item);
+    if (auto container = item->asContainer()) {
+        const Item::List children = container->childItems();
+        for (Item *child : children)
+            itemsPreOrder(child, result);
+    }
+}
+
+}
+
+LayoutSolver::LayoutSolver(ItemBoxContainer *root)
+    : m_root(root)
+    , m_copy(new ItemBoxContainer(nullptr))
+{
+    m_copy->fillFromItem(root);
+
+    Item::List items;
+    itemsPreOrder(root, items);
+    m_originalState.reserve(items.size());
+    for (Item *item : std::as_const(items)) {
+        // Containers derive their constraints from the leaves
+        const bool isContainer = item->isContainer();
+        m_originalState.push_back({ item, item->geometry(), isContainer ? Size() : item->minSize(),
+                                    isContainer ? Size() : item->maxSizeHint(), item->isVisible() });
+    }
+}
+
+LayoutSolver::~LayoutSolver() = default;
+
+void LayoutSolver::setSize_recursive(Size size, ChildrenResizeStrategy strategy)
+{
+    m_operations.push_back([size, strategy](ItemBoxContainer *root) {
+        root->setSize_recursive(size, strategy);
+    });
+}
+
+void LayoutSolver::layoutEqually_recursive()
+{
+    m_operations.push_back([](ItemBoxContainer *root) { root->layoutEqually_recursive(); });
+}
+
+void LayoutSolver::solve()
+{
+    // Only the copy is touched here. It has no host, so no guests or separators are involved.
+    for (const auto &operation : std::as_const(m_operations))
+        operation(m_copy.get());
+
+    m_solved = true;
+}
+
+std::future<void> LayoutSolver::solveAsync()
+{
+    return std::async(std::launch::async, [this] { solve(); });
+}
+
+bool LayoutSolver::isStale() const
+{
+    Item::List items;
+    itemsPreOrder(m_root, items);
+    if (items.size() != int(m_originalState.size()))
+        return true;
+
+    for (int i = 0; i < items.size(); ++i) {
+        const Item *item = items.at(i);
+        const ItemState &state = m_originalState[i];
+        const bool isContainer = item->isContainer();
+        if (item != state.item || item->geometry() != state.geometry
+            || item->isVisible() != state.isVisible
+            || (!isContainer && (item->minSize() != state.minSize || item->maxSizeHint() != state.maxSizeHint)))
+            return true;
+    }
+
+    return false;
+}
+
+bool LayoutSolver::apply()
+{
+    if (!m_solved) {
+        KDDW_ERROR("LayoutSolver::apply: Layout wasn't solved yet");
+        return false;
+    }
+
+    if (!m_root || isStale())
+        return false;
+
+    m_root->copyGeometriesFrom(m_copy.get());
+    return true;
+}
+
+const ItemBoxContainer *LayoutSolver::solvedCopy() const
+{
+    return m_copy.get();
+}
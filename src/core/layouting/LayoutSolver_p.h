@@ -0,0 +1,84 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "kddockwidgets/docks_export.h"
+#include "kddockwidgets/KDDockWidgets.h"
+#include "Item_p.h"
+#include "core/ObjectGuard_p.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace KDDockWidgets::Core {
+
+/// Runs expensive layouting operations on a detached copy of a layout, so they can be
+/// calculated on a worker thread while the GUI thread stays responsive.
+///
+/// The copy has no host, so it has no separators and no guests, it's just geometry.
+/// Usage:
+///  - Construct it on the GUI thread, which copies the tree
+///  - Add the operations, for example setSize_recursive()
+///  - Call solve() or solveAsync(), the real layout isn't touched
+///  - Call apply() on the GUI thread, which sets the new geometries in a single pass
+class DOCKS_EXPORT_FOR_UNIT_TESTS LayoutSolver
+{
+public:
+    explicit LayoutSolver(ItemBoxContainer *root);
+    ~LayoutSolver();
+
+    LayoutSolver(const LayoutSolver &) = delete;
+    LayoutSolver &operator=(const LayoutSolver &) = delete;
+
+    /// Operations to run on the copy, in the order they were added
+    void setSize_recursive(Size, ChildrenResizeStrategy = ChildrenResizeStrategy::Percentage);
+    void layoutEqually_recursive();
+
+    /// Runs the operations on the copy. Can be called from any thread, as long as the solver
+    /// itself isn't being used concurrently.
+    void solve();
+
+    /// Calls solve() on a worker thread
+    /// The solver must outlive the returned future.
+    std::future<void> solveAsync();
+
+    /// Copies the solved geometries into the real layout. Must be called on the GUI thread.
+    /// Returns false, and changes nothing, if the real layout changed since the copy was made,
+    /// in which case the operations should be redone directly on it.
+    bool apply();
+
+    /// Returns the solved copy. For tests.
+    const ItemBoxContainer *solvedCopy() const;
+
+private:
+    bool isStale() const;
+
+    /// What the copy was made from, to detect changes in the real layout
+    struct ItemState
+    {
+        const Item *item = nullptr;
+        Rect geometry;
+        Size minSize;
+        Size maxSizeHint;
+        bool isVisible = false;
+    };
+
+    const ObjectGuard<ItemBoxContainer> m_root;
+    std::unique_ptr<ItemBoxContainer> m_copy;
+    std::vector<ItemState> m_originalState;
+    std::vector<std::function<void(ItemBoxContainer *)>> m_operations;
+    bool m_solved = false;
+};
+
+}
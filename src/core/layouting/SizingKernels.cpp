@@ -0,0 +1,455 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "SizingKernels_p.h"
+
+#include "core/Logging_p.h"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+SizingArrays::SizingArrays(const SizingInfo::List &sizes, Qt::Orientation o)
+    : m_count(int(sizes.size()))
+    , orientation(o)
+    , lengths(ScratchBuffer::allocateInts(size_t(m_count)))
+    , minLengths(ScratchBuffer::allocateInts(size_t(m_count)))
+    , maxLengths(ScratchBuffer::allocateInts(size_t(m_count)))
+{
+    for (int i = 0; i < m_count; ++i) {
+        const SizingInfo &sizing = sizes.at(i);
+        lengths[i] = sizing.length(o);
+        minLengths[i] = sizing.minLength(o);
+        maxLengths[i] = sizing.maxLengthHint(o);
+    }
+}
+
+void SizingArrays::applyLengths(SizingInfo::List &sizes) const
+{
+    assert(sizes.size() == count());
+    for (int i = 0; i < m_count; ++i)
+        sizes[i].setLength(lengths[i], orientation);
+}
+
+void SizingKernels::layoutEqually(SizingArrays &sizes, int lengthToGive)
+{
+    const int count = sizes.count();
+    int *const lengths = sizes.lengths;
+    const int *const mins = sizes.minLengths;
+    const int *const maxs = sizes.maxLengths;
+
+    ScratchBuffer::Scope scratchScope;
+    int *const satisfied = ScratchBuffer::allocateInts(size_t(count));
+    std::fill(satisfied, satisfied + count, 0);
+    int numSatisfied = 0;
+
+    // clear the sizes before we start distributing
+    std::fill(lengths, lengths + count, 0);
+
+    // The sum of what each item is missing to reach its min length.
+    // Kept up to date as lengths change, instead of being summed again for every item.
+    int totalMissing = 0;
+    for (int i = 0; i < count; ++i)
+        totalMissing += std::max(0, mins[i]);
+
+    while (numSatisfied < count) {
+        const int remainingItems = count - numSatisfied;
+        const int suggestedToGive = std::max(1, lengthToGive / remainingItems);
+        const int oldLengthToGive = lengthToGive;
+
+        for (int i = 0; i < count; ++i) {
+            if (satisfied[i])
+                continue;
+
+            if (maxs[i] - lengths[i] <= 0) {
+                // Was already satisfied from the beginning
+                satisfied[i] = 1;
+                ++numSatisfied;
+                continue;
+            }
+
+            // Bound the max length. Our max can't be bigger than the remaining space.
+            // We need to guarantee the min length of the others.
+            const int missing = std::max(0, mins[i] - lengths[i]);
+            const int othersMissing = totalMissing - missing;
+            const int maxLength = std::min(lengths[i] + lengthToGive - othersMissing, maxs[i]);
+            const int newItemLength = bound(mins[i], lengths[i] + suggestedToGive, maxLength);
+            const int toGive = newItemLength - lengths[i];
+
+            if (toGive == 0) {
+                assert(false);
+                satisfied[i] = 1;
+                ++numSatisfied;
+            } else {
+                lengthToGive -= toGive;
+                lengths[i] += toGive;
+                totalMissing += std::max(0, mins[i] - lengths[i]) - missing;
+
+                if (maxs[i] - lengths[i] <= 0) {
+                    satisfied[i] = 1;
+                    ++numSatisfied;
+                }
+
+                if (lengthToGive == 0)
+                    return;
+
+                if (lengthToGive < 0) {
+                    KDDW_ERROR("Breaking infinite loop");
+                    return;
+                }
+            }
+        }
+
+        if (oldLengthToGive == lengthToGive) {
+            // Nothing happened, we can't satisfy more items, due to min/max constraints
+            return;
+        }
+    }
+}
+
+void SizingKernels::honourMaxSizes(SizingArrays &sizes, int containerLength)
+{
+    const int count = sizes.count();
+    int *const lengths = sizes.lengths;
+    const int *const maxs = sizes.maxLengths;
+
+    int amountNeededToShrink = 0;
+    int amountAvailableToGrow = 0;
+
+    ScratchBuffer::Scope scratchScope;
+    int *const shrinkers = ScratchBuffer::allocateInts(size_t(count));
+    int *const growers = ScratchBuffer::allocateInts(size_t(count));
+    int numShrinkers = 0;
+    int numGrowers = 0;
+
+    for (int i = 0; i < count; ++i) {
+        const int neededToShrink = std::max(0, lengths[i] - maxs[i]);
+        const int availableToGrow = maxs[i] - lengths[i];
+
+        if (neededToShrink > 0) {
+            amountNeededToShrink += neededToShrink;
+            shrinkers[numShrinkers++] = i;
+        } else if (availableToGrow > 0) {
+            amountAvailableToGrow = std::min(amountAvailableToGrow + availableToGrow, containerLength);
+            growers[numGrowers++] = i;
+        }
+    }
+
+    // Don't grow more than what's needed
+    amountAvailableToGrow = std::min(amountNeededToShrink, amountAvailableToGrow);
+
+    // Don't shrink more than what's available to grow
+    amountNeededToShrink = std::min(amountAvailableToGrow, amountNeededToShrink);
+
+    if (amountNeededToShrink == 0 || amountAvailableToGrow == 0)
+        return;
+
+    // Round-robin, so all growers participate, and not just one giving everything.
+    // Items which can't grow anymore are compacted out of the list in the same pass.
+    while (amountAvailableToGrow > 0) {
+        const int toGrow = std::max(1, amountAvailableToGrow / numGrowers);
+        int numKept = 0;
+        for (int i = 0; i < numGrowers; ++i) {
+            const int index = growers[i];
+            const int grew = std::min(maxs[index] - lengths[index], toGrow);
+            lengths[index] += grew;
+            amountAvailableToGrow -= grew;
+
+            if (amountAvailableToGrow == 0)
+                break;
+
+            if (maxs[index] - lengths[index] != 0)
+                growers[numKept++] = index;
+        }
+        numGrowers = numKept;
+    }
+
+    // Same for shrinking
+    while (amountNeededToShrink > 0) {
+        const int toShrink = std::max(1, amountNeededToShrink / numShrinkers);
+        int numKept = 0;
+        for (int i = 0; i < numShrinkers; ++i) {
+            const int index = shrinkers[i];
+            const int shrunk = std::min(std::max(0, lengths[index] - maxs[index]), toShrink);
+            lengths[index] -= shrunk;
+            amountNeededToShrink -= shrunk;
+
+            if (amountNeededToShrink == 0)
+                break;
+
+            if (lengths[index] - maxs[index] > 0)
+                shrinkers[numKept++] = index;
+        }
+        numShrinkers = numKept;
+    }
+}
+
+int SizingKernels::calculateSqueezes(int *availabilities, int *squeezes, int count, int needed,
+                                     NeighbourSqueezeStrategy strategy, bool reversed)
+{
+    int missing = needed;
+
+    if (strategy == NeighbourSqueezeStrategy::AllNeighbours) {
+        while (missing > 0) {
+            int numDonors = 0;
+            for (int i = 0; i < count; ++i)
+                numDonors += availabilities[i] > 0;
+
+            if (numDonors == 0)
+                return missing;
+
+            int toTake = missing / numDonors;
+            if (toTake == 0)
+                toTake = missing;
+
+            for (int i = 0; i < count; ++i) {
+                const int available = availabilities[i];
+                if (available == 0)
+                    continue;
+                const int took = std::min({ missing, toTake, available });
+                availabilities[i] -= took;
+                missing -= took;
+                squeezes[i] += took;
+                if (missing == 0)
+                    break;
+            }
+        }
+    } else if (strategy == NeighbourSqueezeStrategy::ImmediateNeighboursFirst) {
+        for (int i = 0; i < count; i++) {
+            const int index = reversed ? count - 1 - i : i;
+
+            const int available = availabilities[index];
+            if (available > 0) {
+                const int took = std::min(missing, available);
+                missing -= took;
+                squeezes[index] += took;
+            }
+
+            if (missing == 0)
+                break;
+        }
+    }
+
+    return missing;
+}
+
+#ifdef DOCKS_DEVELOPER_MODE
+
+void SizingKernels::Reference::layoutEqually(SizingInfo::List &sizes, Qt::Orientation o,
+                                             int lengthToGive)
+{
+    const auto numItems = sizes.count();
+    Vector<int> satisfiedIndexes;
+    satisfiedIndexes.reserve(numItems);
+
+    // clear the sizes before we start distributing
+    for (SizingInfo &size : sizes) {
+        size.setLength(0, o);
+    }
+
+    while (satisfiedIndexes.count() < sizes.count()) {
+        const int remainingItems = int(sizes.count() - satisfiedIndexes.count());
+        const int suggestedToGive = std::max(1, lengthToGive / remainingItems);
+        const auto oldLengthToGive = lengthToGive;
+
+        for (int i = 0; i < numItems; ++i) {
+            if (satisfiedIndexes.contains(i))
+                continue;
+
+            SizingInfo &size = sizes[i];
+            if (size.availableToGrow(o) <= 0) {
+                // Was already satisfied from the beginning
+                satisfiedIndexes.push_back(i);
+                continue;
+            }
+
+            const auto othersMissing =
+                std::accumulate(sizes.constBegin(), sizes.constEnd(), 0,
+                                [o](size_t sum, const SizingInfo &sz) {
+                                    return int(sum) + sz.missingLength(o);
+                                })
+                - size.missingLength(o);
+
+            const auto maxLength =
+                std::min(size.length(o) + lengthToGive - othersMissing, size.maxLengthHint(o));
+
+            const auto newItemLenght =
+                bound(size.minLength(o), size.length(o) + suggestedToGive, maxLength);
+            const auto toGive = newItemLenght - size.length(o);
+
+            if (toGive == 0) {
+                assert(false);
+                satisfiedIndexes.push_back(i);
+            } else {
+                lengthToGive -= toGive;
+                size.incrementLength(toGive, o);
+                if (size.availableToGrow(o) <= 0) {
+                    satisfiedIndexes.push_back(i);
+                }
+                if (lengthToGive == 0)
+                    return;
+
+                if (lengthToGive < 0) {
+                    KDDW_ERROR("Breaking infinite loop");
+                    return;
+                }
+            }
+        }
+
+        if (oldLengthToGive == lengthToGive) {
+            // Nothing happened, we can't satisfy more items, due to min/max constraints
+            return;
+        }
+    }
+}
+
+void SizingKernels::Reference::honourMaxSizes(SizingInfo::List &sizes, Qt::Orientation o,
+                                              int containerLength)
+{
+    int amountNeededToShrink = 0;
+    int amountAvailableToGrow = 0;
+    Vector<int> indexesOfShrinkers;
+    Vector<int> indexesOfGrowers;
+
+    for (int i = 0; i < sizes.count(); ++i) {
+        SizingInfo &info = sizes[i];
+        const int neededToShrink = info.neededToShrink(o);
+        const int availableToGrow = info.availableToGrow(o);
+
+        if (neededToShrink > 0) {
+            amountNeededToShrink += neededToShrink;
+            indexesOfShrinkers.push_back(i); // clazy:exclude=reserve-candidates
+        } else if (availableToGrow > 0) {
+            amountAvailableToGrow = std::min(amountAvailableToGrow + availableToGrow, containerLength);
+            indexesOfGrowers.push_back(i); // clazy:exclude=reserve-candidates
+        }
+    }
+
+    // Don't grow more than what's needed
+    amountAvailableToGrow = std::min(amountNeededToShrink, amountAvailableToGrow);
+
+    // Don't shrink more than what's available to grow
+    amountNeededToShrink = std::min(amountAvailableToGrow, amountNeededToShrink);
+
+    if (amountNeededToShrink == 0 || amountAvailableToGrow == 0)
+        return;
+
+    // Do the growing:
+    while (amountAvailableToGrow > 0) {
+        // Each grower will grow a bit (round-robin)
+        auto toGrow = std::max(1, amountAvailableToGrow / int(indexesOfGrowers.size()));
+
+        for (auto it = indexesOfGrowers.begin(); it != indexesOfGrowers.end();) {
+            const int index = *it;
+            SizingInfo &sizing = sizes[index];
+            const auto grew = std::min(sizing.availableToGrow(o), toGrow);
+            sizing.incrementLength(grew, o);
+            amountAvailableToGrow -= grew;
+
+            if (amountAvailableToGrow == 0) {
+                // We're done growing
+                break;
+            }
+
+            if (sizing.availableToGrow(o) == 0) {
+                // It's no longer a grower
+                it = indexesOfGrowers.erase(it); // clazy:exclude=strict-iterators
+            } else {
+                it++;
+            }
+        }
+    }
+
+    // Do the shrinking:
+    while (amountNeededToShrink > 0) {
+        // Each shrinker will shrink a bit (round-robin)
+        auto toShrink = std::max(1, amountNeededToShrink / int(indexesOfShrinkers.size()));
+
+        for (auto it = indexesOfShrinkers.begin(); it != indexesOfShrinkers.end();) {
+            const int index = *it;
+            SizingInfo &sizing = sizes[index];
+            const auto shrunk = std::min(sizing.neededToShrink(o), toShrink);
+            sizing.incrementLength(-shrunk, o);
+            amountNeededToShrink -= shrunk;
+
+            if (amountNeededToShrink == 0) {
+                // We're done shrinking
+                break;
+            }
+
+            if (sizing.neededToShrink(o) == 0) {
+                // It's no longer a shrinker
+                it = indexesOfShrinkers.erase(it); // clazy:exclude=strict-iterators
+            } else {
+                it++;
+            }
+        }
+    }
+}
+
+Vector<int> SizingKernels::Reference::calculateSqueezes(Vector<int> availabilities, int needed,
+                                                        NeighbourSqueezeStrategy strategy,
+                                                        bool reversed)
+{
+    const auto count = availabilities.count();
+
+    Vector<int> squeezes;
+    squeezes.resize(count);
+    std::fill(squeezes.begin(), squeezes.end(), 0);
+
+    int missing = needed;
+
+    if (strategy == NeighbourSqueezeStrategy::AllNeighbours) {
+        while (missing > 0) {
+            const int numDonors = int(std::count_if(availabilities.cbegin(), availabilities.cend(),
+                                                    [](int num) { return num > 0; }));
+
+            if (numDonors == 0)
+                return {};
+
+            int toTake = missing / numDonors;
+            if (toTake == 0)
+                toTake = missing;
+
+            for (int i = 0; i < count; ++i) {
+                const int available = availabilities.at(i);
+                if (available == 0)
+                    continue;
+                const int took = std::min({ missing, toTake, available });
+                availabilities[i] -= took;
+                missing -= took;
+                squeezes[i] += took;
+                if (missing == 0)
+                    break;
+            }
+        }
+    } else if (strategy == NeighbourSqueezeStrategy::ImmediateNeighboursFirst) {
+        for (int i = 0; i < count; i++) {
+            const auto index = reversed ? count - 1 - i : i;
+
+            const int available = availabilities.at(index);
+            if (available > 0) {
+                const int took = std::min(missing, available);
+                missing -= took;
+                squeezes[index] += took;
+            }
+
+            if (missing == 0)
+                break;
+        }
+    }
+
+    return squeezes;
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "kddockwidgets/docks_export.h"
+#include "kddockwidgets/KDDockWidgets.h"
+#include "Item_p.h"
+#include "Allocators_p.h"
+
+namespace KDDockWidgets::Core {
+
+/// A structure-of-arrays copy of a SizingInfo::List, along a single orientation.
+///
+/// The layouting algorithms in ItemBoxContainer only look at lengths and length constraints of
+/// the container's orientation. Having them in contiguous int arrays keeps the hot loops free of
+/// Rect/Size accessors and orientation branches, so the compiler can vectorize them.
+/// The arrays live in the ScratchBuffer, so no heap allocation happens.
+struct DOCKS_EXPORT_FOR_UNIT_TESTS SizingArrays
+{
+    explicit SizingArrays(const SizingInfo::List &sizes, Qt::Orientation);
+
+    SizingArrays(const SizingArrays &) = delete;
+    SizingArrays &operator=(const SizingArrays &) = delete;
+
+    /// Writes the lengths back into @p sizes, which must be the list we were created from
+    void applyLengths(SizingInfo::List &sizes) const;
+
+    int count() const
+    {
+        return m_count;
+    }
+
+private:
+    // Declared first, so it's released last
+    ScratchBuffer::Scope m_scratchScope;
+    const int m_count;
+
+public:
+    const Qt::Orientation orientation;
+    int *const lengths;
+    int *const minLengths;
+
+    /// Same as SizingInfo::maxLengthHint(), so never smaller than the min length
+    int *const maxLengths;
+};
+
+namespace SizingKernels {
+
+/// Distributes @p lengthToGive equally between the items, while honouring their min and max
+/// lengths. See ItemBoxContainer::layoutEqually()
+DOCKS_EXPORT_FOR_UNIT_TESTS void layoutEqually(SizingArrays &sizes, int lengthToGive);
+
+/// Shrinks the items which are bigger than their max length, giving that length to items that can
+/// still grow. See ItemBoxContainer::Private::honourMaxSizes()
+DOCKS_EXPORT_FOR_UNIT_TESTS void honourMaxSizes(SizingArrays &sizes, int containerLength);
+
+/// Calculates how much to squeeze each of the @p count neighbours, so that @p needed length is
+/// freed. @p availabilities is consumed and @p squeezes must be zero initialized.
+/// Returns how much is still missing, which is only positive if there wasn't enough available
+/// length.
+DOCKS_EXPORT_FOR_UNIT_TESTS int calculateSqueezes(int *availabilities, int *squeezes, int count,
+                                                  int needed, NeighbourSqueezeStrategy,
+                                                  bool reversed);
+
+#ifdef DOCKS_DEVELOPER_MODE
+/// The original implementations, operating directly on SizingInfo::List.
+/// Kept so tests can check that the kernels above produce exactly the same results.
+namespace Reference {
+DOCKS_EXPORT_FOR_UNIT_TESTS void layoutEqually(SizingInfo::List &sizes, Qt::Orientation,
+                                               int lengthToGive);
+DOCKS_EXPORT_FOR_UNIT_TESTS void honourMaxSizes(SizingInfo::List &sizes, Qt::Orientation,
+                                                int containerLength);
+DOCKS_EXPORT_FOR_UNIT_TESTS Vector<int> calculateSqueezes(Vector<int> availabilities, int needed,
+                                                          NeighbourSqueezeStrategy,
+                                                          bool reversed);
+}
+#endif
+
+}
+
+}
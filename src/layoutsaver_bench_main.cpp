@@ -0,0 +1,433 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/// Layout save/restore benchmark.
+///
+/// Generates layouts of increasing size (nested splits, tabs, floating windows, side bars and
+/// closed dock widgets with placeholders) and times each phase of a save/restore cycle
+/// separately: LayoutSaver::serializeLayout(), Layout::fromJson(), Layout::scaleSizes() and
+/// LayoutSaver::restoreLayout(). For each phase it prints how much the resident set size grew,
+/// and the process' peak RSS so far, which is a high-water mark and not specific to the phase.
+///
+/// Like kddockwidgets_linter it can also restore arbitrary layout files, passed as positional
+/// arguments. Use -o to write the generated corpus to a directory, so it can be versioned and
+/// compared between releases.
+
+#include "Config.h"
+#include "LayoutSaver.h"
+#include "core/LayoutSaver_p.h"
+#include "core/DockRegistry.h"
+#include "core/DockWidget.h"
+#include "core/FloatingWindow.h"
+#include "core/MainWindow.h"
+#include "core/Platform.h"
+#include "core/ViewFactory.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+
+namespace {
+
+constexpr auto s_mainWindowName = "bench-mainwindow";
+
+/// Returns the peak resident set size of this process so far, in KiB. -1 if unsupported.
+/// It's a high-water mark for the whole process, so it never goes down between phases.
+long peakRssKiB()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef Q_OS_MACOS
+    return long(usage.ru_maxrss / 1024); // bytes on macOS
+#else
+    return long(usage.ru_maxrss);
+#endif
+#else
+    return -1;
+#endif
+}
+
+/// Returns the current resident set size of this process, in KiB. -1 if unsupported.
+long currentRssKiB()
+{
+#ifdef Q_OS_LINUX
+    QFile file(QStringLiteral("/proc/self/statm"));
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    // Fields are in pages: size resident shared text lib data dt
+    QTextStream stream(&file);
+    long sizePages = 0;
+    long residentPages = 0;
+    stream >> sizePages >> residentPages;
+    if (stream.status() != QTextStream::Ok)
+        return -1;
+
+    return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return -1;
+#endif
+}
+
+template<typename Func>
+qint64 measure(Func &&func)
+{
+    QElapsedTimer timer;
+    timer.start();
+    func();
+    return timer.nsecsElapsed();
+}
+
+struct PhaseResult
+{
+    const char *name = nullptr;
+    double bestMs = -1;
+    long peakRssSoFar = -1;
+
+    // The largest RSS growth of a single run of this phase
+    long rssGrowth = 0;
+    bool hasRssGrowth = false;
+
+    template<typename Func>
+    void run(Func &&func)
+    {
+        const long rssBefore = currentRssKiB();
+        const double ms = double(measure(func)) / 1000000.0;
+        const long rssAfter = currentRssKiB();
+
+        if (bestMs < 0 || ms < bestMs)
+            bestMs = ms;
+
+        if (rssBefore >= 0 && rssAfter >= 0) {
+            rssGrowth = hasRssGrowth ? std::max(rssGrowth, rssAfter - rssBefore) : rssAfter - rssBefore;
+            hasRssGrowth = true;
+        }
+
+        peakRssSoFar = peakRssKiB();
+    }
+};
+
+void printResults(const QString &label, int numDockWidgets, qsizetype jsonSize,
+                  const std::vector<PhaseResult> &phases)
+{
+    std::printf("%s: dockWidgets=%d json=%lldKiB\n", qPrintable(label), numDockWidgets,
+                static_cast<long long>(jsonSize / 1024));
+    for (const PhaseResult &phase : phases) {
+        if (phase.hasRssGrowth) {
+            std::printf("  %-16s %10.2fms  rssGrowth=%ldKiB  peakRssSoFar=%ldKiB\n", phase.name,
+                        phase.bestMs, phase.rssGrowth, phase.peakRssSoFar);
+        } else {
+            std::printf("  %-16s %10.2fms  peakRssSoFar=%ldKiB\n", phase.name, phase.bestMs,
+                        phase.peakRssSoFar);
+        }
+    }
+}
+
+void deleteAllTopLevels()
+{
+    auto dr = DockRegistry::self();
+    qDeleteAll(dr->floatingWindows(/*includeBeingDeleted=*/true));
+    qDeleteAll(dr->dockwidgets());
+    qDeleteAll(dr->mainwindows());
+    QCoreApplication::processEvents();
+}
+
+Core::DockWidget *createDockWidget(int index)
+{
+    return Config::self()
+        .viewFactory()
+        ->createDockWidget(QStringLiteral("bench-dock-%1").arg(index))
+        ->asDockWidgetController();
+}
+
+/// Populates a main window with @p numDockWidgets dock widgets.
+/// Roughly 60% are docked (nested or tabbed), 15% float, 10% go to side bars and 15% are closed,
+/// leaving placeholders behind.
+/// Uses a fixed seed, so the same size always produces the same layout.
+Core::MainWindow *generateLayout(int numDockWidgets)
+{
+    const int numDocked = std::max(1, numDockWidgets * 60 / 100);
+    const int numFloating = numDockWidgets * 15 / 100;
+    const int numSideBar = numDockWidgets * 10 / 100;
+    const int numClosed = numDockWidgets - numDocked - numFloating - numSideBar;
+
+    // Big enough so that the docked widgets don't need to grow the window
+    const int side = std::max(1000, int(std::ceil(std::sqrt(double(numDocked)))) * 110);
+    CreateViewOptions viewOpts;
+    viewOpts.isVisible = true;
+    viewOpts.size = Size(side, side);
+    auto mainWindow = Platform::instance()->createMainWindow(QString::fromLatin1(s_mainWindowName),
+                                                             viewOpts, MainWindowOption_None);
+    mainWindow->show();
+    mainWindow->view()->resize(Size(side, side));
+
+    std::mt19937 rng(numDockWidgets);
+    const Location locations[] = { Location_OnLeft, Location_OnTop, Location_OnRight, Location_OnBottom };
+
+    int index = 0;
+    std::vector<Core::DockWidget *> docked;
+    docked.reserve(size_t(numDocked));
+    for (int i = 0; i < numDocked; ++i) {
+        auto dw = createDockWidget(index++);
+        if (docked.empty()) {
+            mainWindow->addDockWidget(dw, Location_OnLeft);
+        } else {
+            Core::DockWidget *relativeTo = docked[rng() % docked.size()];
+            if (rng() % 3 == 0) {
+                relativeTo->addDockWidgetAsTab(dw);
+            } else {
+                mainWindow->addDockWidget(dw, locations[rng() % 4], relativeTo);
+            }
+        }
+        docked.push_back(dw);
+    }
+
+    // Floating windows hold up to 4 dock widgets each
+    Core::DockWidget *floatingRoot = nullptr;
+    for (int i = 0; i < numFloating; ++i) {
+        auto dw = createDockWidget(index++);
+        if (i % 4 == 0) {
+            dw->open();
+            if (auto fw = dw->floatingWindow())
+                fw->view()->window()->setGeometry(Rect(50 + (i % 20) * 10, 50 + (i % 20) * 10, 400, 400));
+            floatingRoot = dw;
+        } else if (i % 4 == 1) {
+            floatingRoot->addDockWidgetAsTab(dw);
+        } else {
+            floatingRoot->addDockWidgetToContainingWindow(dw, locations[rng() % 4], floatingRoot);
+        }
+    }
+
+    for (int i = 0; i < numSideBar; ++i) {
+        auto dw = createDockWidget(index++);
+        mainWindow->addDockWidget(dw, Location_OnBottom);
+        mainWindow->moveToSideBar(dw);
+    }
+
+    // Closed dock widgets leave a placeholder in the layout, so they can be restored later
+    for (int i = 0; i < numClosed; ++i) {
+        auto dw = createDockWidget(index++);
+        mainWindow->addDockWidget(dw, locations[rng() % 4], docked[rng() % docked.size()]);
+        dw->close();
+    }
+
+    QCoreApplication::processEvents();
+    return mainWindow;
+}
+
+/// Runs all phases against @p data. The dock widgets and main windows referenced by the layout
+/// are expected to exist already, or to be creatable via the factory functions.
+std::vector<PhaseResult> benchmarkRestore(const QByteArray &data, RestoreOptions options,
+                                          int iterations)
+{
+    std::vector<PhaseResult> phases(3);
+    phases[0].name = "fromJson";
+    phases[1].name = "scaleSizes";
+    phases[2].name = "restoreLayout";
+
+    for (int i = 0; i < iterations; ++i) {
+        // fromJson() fills this static, clear it so every iteration starts from the same state
+        LayoutSaver::DockWidget::s_dockWidgets.clear();
+
+        LayoutSaver::Layout layout;
+        phases[0].run([&layout, &data] { layout.fromJson(data); });
+
+        // Restoring relative to the main window is what triggers scaling
+        phases[1].run([&layout] {
+            layout.scaleSizes(InternalRestoreOptions(InternalRestoreOption::SkipMainWindowGeometry)
+                              | InternalRestoreOption::RelativeFloatingWindowGeometry);
+        });
+    }
+
+    for (int i = 0; i < iterations; ++i) {
+        LayoutSaver restorer(options);
+        phases[2].run([&restorer, &data] {
+            if (!restorer.restoreLayout(data))
+                qWarning() << "Failed to restore layout";
+        });
+    }
+
+    return phases;
+}
+
+PhaseResult benchmarkSerialize(QByteArray &data, int iterations)
+{
+    PhaseResult result;
+    result.name = "serializeLayout";
+    for (int i = 0; i < iterations; ++i) {
+        LayoutSaver saver;
+        result.run([&saver, &data] { data = saver.serializeLayout(); });
+    }
+    return result;
+}
+
+bool benchmarkGenerated(int numDockWidgets, int iterations, const QString &outputDir)
+{
+    deleteAllTopLevels();
+    std::unique_ptr<Core::MainWindow> mainWindow(generateLayout(numDockWidgets));
+
+    QByteArray data;
+    const PhaseResult serializeResult = benchmarkSerialize(data, iterations);
+
+    if (!outputDir.isEmpty()) {
+        QFile f(QDir(outputDir).filePath(QStringLiteral("bench_%1.json").arg(numDockWidgets)));
+        if (!f.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to open" << f.fileName();
+            return false;
+        }
+        f.write(data);
+    }
+
+    // Shrink the main window, so scaleSizes() and restoreLayout() have actual scaling to do
+    mainWindow->view()->resize(mainWindow->view()->size() * 0.9);
+
+    std::vector<PhaseResult> phases = benchmarkRestore(data, RestoreOption_RelativeToMainWindow, iterations);
+    phases.insert(phases.begin(), serializeResult);
+    printResults(QStringLiteral("generated"), numDockWidgets, data.size(), phases);
+
+    mainWindow.reset();
+    deleteAllTopLevels();
+    return true;
+}
+
+bool benchmarkFile(const QString &filename, int iterations)
+{
+    QFile f(filename);
+    if (!f.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open" << filename;
+        return false;
+    }
+
+    const QByteArray data = f.readAll();
+    deleteAllTopLevels();
+
+    // Same factories as the linter, so any layout can be restored
+    KDDockWidgets::Config::self().setDockWidgetFactoryFunc([](const QString &dwName) {
+        return Config::self().viewFactory()->createDockWidget(dwName)->asDockWidgetController();
+    });
+    KDDockWidgets::Config::self().setMainWindowFactoryFunc([](const QString &mwName, MainWindowOptions mainWindowOptions) {
+        return Platform::instance()->createMainWindow(mwName, {}, mainWindowOptions);
+    });
+
+    // Run a first restore, so main windows are created and scaleSizes() has something to scale against
+    {
+        LayoutSaver restorer;
+        if (!restorer.restoreLayout(data)) {
+            qWarning() << "Failed to restore" << filename;
+            return false;
+        }
+    }
+
+    QByteArray serialized;
+    std::vector<PhaseResult> phases = benchmarkRestore(data, {}, iterations);
+    phases.push_back(benchmarkSerialize(serialized, iterations));
+
+    printResults(filename, int(DockRegistry::self()->dockwidgets().size()), data.size(), phases);
+
+    deleteAllTopLevels();
+    KDDockWidgets::Config::self().setDockWidgetFactoryFunc(nullptr);
+    KDDockWidgets::Config::self().setMainWindowFactoryFunc(nullptr);
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    const auto frontends = Platform::frontendTypes();
+    if (frontends.empty()) {
+        qWarning() << "Error: Your KDDockWidgets installation doesn't support any frontend!";
+        return -1;
+    }
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("KDDockWidgets layout save/restore benchmark");
+    QCommandLineOption forceQtQuick = { { "q", "force-qtquick" }, "Forces usage of QtQuick" };
+    QCommandLineOption sizesOpt = { { "n", "sizes" }, "Comma separated number of dock widgets to generate", "sizes", "10,50,100,500,1000,5000" };
+    QCommandLineOption iterationsOpt = { { "i", "iterations" }, "Iterations per phase, the best one is reported", "count", "3" };
+    QCommandLineOption outputDirOpt = { { "o", "output-dir" }, "Writes the generated layouts to this directory", "dir" };
+
+    parser.addOption(sizesOpt);
+    parser.addOption(iterationsOpt);
+    parser.addOption(outputDirOpt);
+    parser.addPositionalArgument("layout", "layout json files to benchmark instead of generated ones");
+    parser.addHelpOption();
+
+    FrontendType frontendType = FrontendType::QtWidgets;
+
+#if defined(KDDW_FRONTEND_QTQUICK)
+#if defined(KDDW_FRONTEND_QTWIDGETS)
+    // There's both frontends, so add a switch to chose QtQuick
+    parser.addOption(forceQtQuick);
+#else
+    // There's only QtQuick
+    frontendType = FrontendType::QtQuick;
+#endif
+#endif
+
+    parser.process(*qApp);
+
+#if defined(KDDW_FRONTEND_QTQUICK) && defined(KDDW_FRONTEND_QTWIDGETS)
+    if (parser.isSet(forceQtQuick))
+        frontendType = FrontendType::QtQuick;
+#endif
+
+    KDDockWidgets::initFrontend(frontendType);
+    KDDockWidgets::Config::self().setFlags(KDDockWidgets::Config::self().flags() | Config::Flag_AutoHideSupport);
+
+    const int iterations = std::max(1, parser.value(iterationsOpt).toInt());
+    const QStringList files = parser.positionalArguments();
+
+    int exitCode = 0;
+    if (files.isEmpty()) {
+        const QStringList sizes = parser.value(sizesOpt).split(QLatin1Char(','));
+        for (const QString &size : sizes) {
+            const int numDockWidgets = size.toInt();
+            if (numDockWidgets <= 0) {
+                qWarning() << "Invalid size" << size;
+                return 3;
+            }
+
+            if (!benchmarkGenerated(numDockWidgets, iterations, parser.value(outputDirOpt)))
+                exitCode = 2;
+        }
+    } else {
+        for (const QString &file : files) {
+            if (!benchmarkFile(file, iterations))
+                exitCode = 2;
+        }
+    }
+
+    return exitCode;
+}
@@ -18,6 +18,7 @@
 #include "core/Logging_p.h"
 #include "core/DelayedCall_p.h"
 #include "qtcommon/View.h"
+#include "qtcommon/WrapperCache_p.h"
 
 #include <QWindow>
 #include <QDebug>
@@ -47,18 +48,59 @@ public:
         }
     }
 
+    /// Returns the EventFilterInterface::EventInterest for the specified event type
+    /// or EventInterest_None if it's not an event our filters can handle
+    static int eventInterestFor(QEvent::Type type)
+    {
+        switch (type) {
+        case QEvent::Expose:
+            return EventFilterInterface::EventInterest_Expose;
+        case QEvent::MouseButtonPress:
+            return EventFilterInterface::EventInterest_MouseButtonPress;
+        case QEvent::MouseButtonRelease:
+            return EventFilterInterface::EventInterest_MouseButtonRelease;
+        case QEvent::MouseMove:
+            return EventFilterInterface::EventInterest_MouseMove;
+        case QEvent::MouseButtonDblClick:
+            return EventFilterInterface::EventInterest_MouseDoubleClick;
+        case QEvent::NonClientAreaMouseButtonPress:
+        case QEvent::NonClientAreaMouseButtonRelease:
+        case QEvent::NonClientAreaMouseMove:
+        case QEvent::NonClientAreaMouseButtonDblClick:
+            return EventFilterInterface::EventInterest_NonClientAreaMouse;
+        case QEvent::DragEnter:
+        case QEvent::DragLeave:
+        case QEvent::DragMove:
+        case QEvent::Drop:
+            return EventFilterInterface::EventInterest_DnD;
+        case QEvent::Move:
+            return EventFilterInterface::EventInterest_Move;
+        default:
+            break;
+        }
+
+        return EventFilterInterface::EventInterest_None;
+    }
+
     bool eventFilter(QObject *o, QEvent *ev) override
     {
-        if (ev->type() == QEvent::Expose)
-            return handleExpose(o);
-        else if (QMouseEvent *me = mouseEvent(ev))
-            return handleMouseEvent(o, me);
-        else if (isDnDEvent(ev))
-            return handleDnDEvent(o, ev);
-        else if (ev->type() == QEvent::Move)
-            return handleMoveEvent(o, ev);
-        else if (ev->type() != QEvent::Quit || m_isProcessingAppQuitEvent)
+        if (const int interest = eventInterestFor(ev->type())) {
+            // We see every event of every object in the application. Bail out before
+            // doing anything expensive, such as creating a View wrapper, if no filter wants it.
+            if ((q->d->m_globalEventInterests & interest) == 0)
+                return false;
+
+            if (ev->type() == QEvent::Expose)
+                return handleExpose(o);
+            else if (QMouseEvent *me = mouseEvent(ev))
+                return handleMouseEvent(o, me, interest);
+            else if (isDnDEvent(ev))
+                return handleDnDEvent(o, ev);
+            else
+                return handleMoveEvent(o, ev);
+        } else if (ev->type() != QEvent::Quit || m_isProcessingAppQuitEvent) {
             return false;
+        }
 
         auto view = Platform_qt::instance()->qobjectAsView(o);
         if (!view)
@@ -77,7 +119,8 @@ public:
 
         auto view = Platform_qt::instance()->qobjectAsView(o);
         for (EventFilterInterface *filter : std::as_const(q->d->m_globalEventFilters)) {
-            if (filter->onMoveEvent(view.get()))
+            if ((filter->eventInterests() & EventFilterInterface::EventInterest_Move)
+                && filter->onMoveEvent(view.get()))
                 return true;
         }
 
@@ -91,7 +134,8 @@ public:
 
         if (auto view = Platform_qt::instance()->qobjectAsView(o)) {
             for (EventFilterInterface *filter : std::as_const(q->d->m_globalEventFilters)) {
-                if (filter->onDnDEvent(view.get(), ev))
+                if ((filter->eventInterests() & EventFilterInterface::EventInterest_DnD)
+                    && filter->onDnDEvent(view.get(), ev))
                     return true;
             }
         }
@@ -109,14 +153,15 @@ public:
             return false;
 
         for (EventFilterInterface *filter : std::as_const(q->d->m_globalEventFilters)) {
-            if (filter->enabled() && filter->onExposeEvent(window))
+            if (filter->enabled() && (filter->eventInterests() & EventFilterInterface::EventInterest_Expose)
+                && filter->onExposeEvent(window))
                 return true;
         }
 
         return false;
     }
 
-    bool handleMouseEvent(QObject *watched, QMouseEvent *ev)
+    bool handleMouseEvent(QObject *watched, QMouseEvent *ev, int interest)
     {
         if (q->d->m_globalEventFilters.empty())
             return false;
@@ -126,15 +171,17 @@ public:
         // Make a copy, as there could be reentrancy and filters getting removed while event being
         // processed
         const auto filters = std::as_const(q->d->m_globalEventFilters);
+        const unsigned int changeCount = q->d->m_globalEventFiltersChangeCount;
 
         for (EventFilterInterface *filter : filters) {
-            // Filter might have been deleted meanwhile
-            if (std::find(q->d->m_globalEventFilters.cbegin(), q->d->m_globalEventFilters.cend(),
-                          filter)
-                == q->d->m_globalEventFilters.cend())
+            // Filter might have been deleted meanwhile. Only need to look if filters changed.
+            if (changeCount != q->d->m_globalEventFiltersChangeCount
+                && std::find(q->d->m_globalEventFilters.cbegin(), q->d->m_globalEventFilters.cend(),
+                             filter)
+                    == q->d->m_globalEventFilters.cend())
                 continue;
 
-            if (!filter->enabled())
+            if (!filter->enabled() || (filter->eventInterests() & interest) == 0)
                 continue;
 
             if (filter->onMouseEvent(view.get(), ev))
@@ -174,6 +221,8 @@ Platform_qt::GlobalEventFilter::~GlobalEventFilter() = default;
 
 Platform_qt::Platform_qt()
     : m_globalEventFilter(new GlobalEventFilter(this))
+    , m_viewWrappers(new WrapperCache<Core::View>())
+    , m_windowWrappers(new WrapperCache<Core::Window>())
 {
     if (!qGuiApp)
         qWarning() << "Please call KDDockWidgets::initPlatform() after QGuiApplication";
@@ -182,6 +231,31 @@ Platform_qt::Platform_qt()
 Platform_qt::~Platform_qt()
 {
     delete m_globalEventFilter;
+    delete m_viewWrappers;
+    delete m_windowWrappers;
+}
+
+std::shared_ptr<View> Platform_qt::cachedViewWrapper(QObject *obj,
+                                                     const std::function<std::shared_ptr<View>()> &create) const
+{
+    if (!obj)
+        return {};
+
+    return m_viewWrappers->get(obj, create);
+}
+
+void Platform_qt::discardViewWrapper(QObject *obj) const
+{
+    m_viewWrappers->remove(obj);
+}
+
+std::shared_ptr<Core::Window> Platform_qt::cachedWindowWrapper(QWindow *window,
+                                                               const std::function<std::shared_ptr<Core::Window>()> &create) const
+{
+    if (!window)
+        return {};
+
+    return m_windowWrappers->get(window, create);
 }
 
 std::shared_ptr<View> Platform_qt::focusedView() const
@@ -355,6 +429,8 @@ int Platform_qt::s_logicalDpiFactorOverride = 0;
 // ctor used by the tests only
 Platform_qt::Platform_qt(QCoreApplication *)
     : m_globalEventFilter(new GlobalEventFilter(this))
+    , m_viewWrappers(new WrapperCache<Core::View>())
+    , m_windowWrappers(new WrapperCache<Core::Window>())
 {
     // We want stability during tests.
     // QMainWindow uses the factor for its margins, we don't want tests failing due
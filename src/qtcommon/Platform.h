@@ -14,6 +14,8 @@
 #include "kddockwidgets/docks_export.h"
 #include "kddockwidgets/core/Platform.h"
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 class QCoreApplication;
 QT_END_NAMESPACE
@@ -27,6 +29,9 @@ class View;
 
 namespace QtCommon {
 
+template<typename T>
+class WrapperCache;
+
 /// @brief Baseclass platform for Qt based platform
 /// Useful since QtWidgets and QtQuick share some similarities
 class DOCKS_EXPORT Platform_qt : public Core::Platform
@@ -65,6 +70,20 @@ public:
 
     static Platform_qt *instance();
 
+    /// @brief Returns the View wrapper cached for @p obj, calling @p create to make it the first time
+    /// Wrappers are kept until their QObject is destroyed, so the same QObject always gets the same
+    /// wrapper and wrapping it again doesn't allocate.
+    std::shared_ptr<Core::View> cachedViewWrapper(QObject *obj,
+                                                  const std::function<std::shared_ptr<Core::View>()> &create) const;
+
+    /// @brief Forgets the View wrapper cached for @p obj
+    /// Called when a KDDW view is created or destroyed, as its wrapper refers to its controller
+    void discardViewWrapper(QObject *obj) const;
+
+    /// @brief Returns the Window wrapper cached for @p window, calling @p create to make it the first time
+    std::shared_ptr<Core::Window> cachedWindowWrapper(QWindow *window,
+                                                      const std::function<std::shared_ptr<Core::Window>()> &create) const;
+
     std::shared_ptr<Core::Screen> primaryScreen() const override;
 
     void runDelayed(int ms, Core::DelayedCall *) override;
@@ -115,6 +134,8 @@ protected:
 private:
     class GlobalEventFilter;
     GlobalEventFilter *const m_globalEventFilter;
+    WrapperCache<Core::View> *const m_viewWrappers;
+    WrapperCache<Core::Window> *const m_windowWrappers;
     Q_DISABLE_COPY(Platform_qt)
 };
 
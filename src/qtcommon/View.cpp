@@ -10,6 +10,7 @@
 */
 
 #include "View.h"
+#include "Platform.h"
 #include "core/Utils_p.h"
 #include "core/View_p.h"
 #include "kddockwidgets/core/Controller.h"
@@ -49,16 +50,38 @@ public:
 
 View_qt::View_qt(Core::Controller *controller, Core::ViewType type, QObject *thisObj)
     : View(controller, type)
-    , m_eventFilter(thisObj ? new EventFilter(this, thisObj) : nullptr)
     , m_thisObj(thisObj)
 {
+    // Wrappers are cached and outlive the caller, so they only filter the wrapped
+    // object's events once someone is interested
+    if (type != Core::ViewType::ViewWrapper)
+        ensureEventFilter();
+
+    // A wrapper made while the QObject was being constructed wouldn't know its controller
+    if (thisObj && type != Core::ViewType::ViewWrapper && Core::Platform::hasInstance())
+        Platform_qt::instance()->discardViewWrapper(thisObj);
 }
 
 View_qt::~View_qt()
 {
+    // The cached wrapper points to our controller, which is about to be deleted
+    if (m_thisObj && !View::is(Core::ViewType::ViewWrapper) && Core::Platform::hasInstance())
+        Platform_qt::instance()->discardViewWrapper(m_thisObj);
+
     delete m_eventFilter;
 }
 
+void View_qt::ensureEventFilter()
+{
+    if (!m_eventFilter && m_thisObj)
+        m_eventFilter = new EventFilter(this, m_thisObj);
+}
+
+void View_qt::onViewEventFilterInstalled()
+{
+    ensureEventFilter();
+}
+
 View_qt::EventFilter::~EventFilter() = default;
 
 QObject *View_qt::thisObject() const
@@ -53,10 +53,15 @@ public:
     }
 
 protected:
+    void onViewEventFilterInstalled() override;
+
     class EventFilter;
-    EventFilter *const m_eventFilter;
+    EventFilter *m_eventFilter = nullptr;
     QObject *const m_thisObj;
     Q_DISABLE_COPY(View_qt)
+
+private:
+    void ensureEventFilter();
 };
 
 }
@@ -0,0 +1,93 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <QObject>
+
+#include <memory>
+#include <unordered_map>
+
+namespace KDDockWidgets::QtCommon {
+
+/// Keeps a single wrapper (View or Window) per QObject.
+///
+/// Wrapping the same QObject again returns the same instance instead of allocating a new one.
+/// The wrapper is kept alive until the QObject is destroyed.
+/// GUI thread only.
+template<typename T>
+class WrapperCache
+{
+public:
+    WrapperCache() = default;
+
+    ~WrapperCache()
+    {
+        clear();
+    }
+
+    /// Returns the wrapper for @p obj, calling @p create to make it the first time
+    template<typename Factory>
+    std::shared_ptr<T> get(QObject *obj, Factory create)
+    {
+        auto it = m_entries.find(obj);
+        if (it != m_entries.end())
+            return it->second.wrapper;
+
+        std::shared_ptr<T> wrapper = create();
+        if (!wrapper)
+            return wrapper;
+
+        auto connection = QObject::connect(obj, &QObject::destroyed, [this, obj] { remove(obj); });
+        m_entries.emplace(obj, Entry { wrapper, connection });
+        return wrapper;
+    }
+
+    /// Forgets the wrapper for @p obj, if any
+    void remove(QObject *obj)
+    {
+        auto it = m_entries.find(obj);
+        if (it == m_entries.end())
+            return;
+
+        QObject::disconnect(it->second.connection);
+
+        // Destroying the wrapper might re-enter, so erase before it goes out of scope
+        const std::shared_ptr<T> wrapper = std::move(it->second.wrapper);
+        m_entries.erase(it);
+    }
+
+    void clear()
+    {
+        auto entries = std::move(m_entries);
+        m_entries.clear();
+        for (auto &it : entries)
+            QObject::disconnect(it.second.connection);
+    }
+
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<T> wrapper;
+        QMetaObject::Connection connection;
+    };
+
+    std::unordered_map<QObject *, Entry> m_entries;
+
+    Q_DISABLE_COPY(WrapperCache)
+};
+
+}
@@ -123,7 +123,7 @@ std::shared_ptr<Core::View> Platform::qobjectAsView(QObject *obj) const
 
 std::shared_ptr<Core::Window> Platform::windowFromQWindow(QWindow *qwindow) const
 {
-    return std::shared_ptr<Core::Window>(new Window(qwindow));
+    return cachedWindowWrapper(qwindow, [qwindow] { return std::shared_ptr<Core::Window>(new Window(qwindow)); });
 }
 
 Core::ViewFactory *Platform::createDefaultViewFactory()
@@ -133,10 +133,8 @@ Core::ViewFactory *Platform::createDefaultViewFactory()
 
 Core::Window::Ptr Platform::windowAt(QPoint globalPos) const
 {
-    if (auto qwindow = qGuiApp->QGuiApplication::topLevelAt(globalPos)) {
-        auto window = new Window(qwindow);
-        return Core::Window::Ptr(window);
-    }
+    if (auto qwindow = qGuiApp->QGuiApplication::topLevelAt(globalPos))
+        return windowFromQWindow(qwindow);
 
     return {};
 }
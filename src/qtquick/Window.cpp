@@ -10,6 +10,7 @@
 */
 
 #include "Window_p.h"
+#include "Platform.h"
 #include "views/View.h"
 
 #include <QWindow>
@@ -64,7 +65,7 @@ std::shared_ptr<Core::View> Window::rootView() const
 Core::Window::Ptr Window::transientParent() const
 {
     if (QWindow *w = m_window->transientParent())
-        return Core::Window::Ptr(new Window(w));
+        return Platform::instance()->windowFromQWindow(w);
 
     return nullptr;
 }
@@ -35,6 +35,7 @@
 
 #include "kdbindings/signal.h"
 
+#include <algorithm>
 #include <unordered_map>
 
 using namespace KDDockWidgets;
@@ -44,16 +45,166 @@ class QtQuick::TabBar::Private
 {
 public:
     Private(Core::TabBar *controller, TabBar *q)
-        : m_dockWidgetModel(new DockWidgetModel(controller, q))
+        : q(q)
+        , m_dockWidgetModel(new DockWidgetModel(controller, q))
     {
+        const auto invalidate = [this] { invalidateTabItems(); };
+        m_modelConnections = {
+            QObject::connect(m_dockWidgetModel, &QAbstractItemModel::rowsInserted, q, invalidate),
+            QObject::connect(m_dockWidgetModel, &QAbstractItemModel::rowsRemoved, q, invalidate),
+            QObject::connect(m_dockWidgetModel, &QAbstractItemModel::rowsMoved, q, invalidate),
+            QObject::connect(m_dockWidgetModel, &QAbstractItemModel::layoutChanged, q, invalidate),
+            QObject::connect(m_dockWidgetModel, &QAbstractItemModel::modelReset, q, invalidate)
+        };
     }
 
+    ~Private()
+    {
+        disconnectAll(m_modelConnections);
+        disconnectAll(m_tabItemConnections);
+    }
+
+    static void disconnectAll(QVector<QMetaObject::Connection> &connections)
+    {
+        for (const auto &connection : std::as_const(connections))
+            QObject::disconnect(connection);
+        connections.clear();
+    }
+
+    void invalidateTabItems()
+    {
+        m_tabItemsDirty = true;
+        m_tabRectsDirty = true;
+    }
+
+    QQuickItem *qmlTabAt(int index) const;
+    const QVector<QPointer<QQuickItem>> &tabItems();
+    void ensureTabRects();
+    int indexAt(QPointF globalPos);
+
+    TabBar *const q;
     int m_hoveredTabIndex = -1;
     QPointer<QQuickItem> m_tabBarQmlItem;
     DockWidgetModel *const m_dockWidgetModel;
     KDBindings::ScopedConnection m_tabBarAutoHideChanged;
+
+    /// The tab items and their geometry, cached so hit-testing doesn't need to call into QML.
+    /// Items are fetched again when the model changes, rects when an item moves or resizes.
+    QVector<QPointer<QQuickItem>> m_tabItems;
+    QVector<QRectF> m_tabRects; // In the coordinates of the tabs' parent item
+    QVector<QMetaObject::Connection> m_tabItemConnections;
+    QVector<QMetaObject::Connection> m_modelConnections;
+    bool m_tabItemsDirty = true;
+    bool m_tabRectsDirty = true;
+    bool m_tabsSortedByX = false;
 };
 
+QQuickItem *QtQuick::TabBar::Private::qmlTabAt(int index) const
+{
+    QVariant result;
+    const bool res = QMetaObject::invokeMethod(
+        m_tabBarQmlItem, "getTabAtIndex", Q_RETURN_ARG(QVariant, result), Q_ARG(QVariant, index));
+
+    if (res)
+        return result.value<QQuickItem *>();
+
+    qWarning() << Q_FUNC_INFO << "Could not find tab for index" << index;
+    return nullptr;
+}
+
+const QVector<QPointer<QQuickItem>> &QtQuick::TabBar::Private::tabItems()
+{
+    if (!m_tabItemsDirty)
+        return m_tabItems;
+
+    disconnectAll(m_tabItemConnections);
+    m_tabItems.clear();
+    m_tabRectsDirty = true;
+
+    if (!m_tabBarQmlItem)
+        return m_tabItems;
+
+    const int count = m_dockWidgetModel->count();
+    m_tabItems.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QQuickItem *item = qmlTabAt(i);
+        if (!item) {
+            // QML didn't create the tab yet, try again next time
+            disconnectAll(m_tabItemConnections);
+            m_tabItems.clear();
+            return m_tabItems;
+        }
+
+        const auto invalidateRects = [this] { m_tabRectsDirty = true; };
+        const auto invalidateItems = [this] { invalidateTabItems(); };
+        m_tabItemConnections << QObject::connect(item, &QQuickItem::xChanged, q, invalidateRects)
+                             << QObject::connect(item, &QQuickItem::yChanged, q, invalidateRects)
+                             << QObject::connect(item, &QQuickItem::widthChanged, q, invalidateRects)
+                             << QObject::connect(item, &QQuickItem::heightChanged, q, invalidateRects)
+                             << QObject::connect(item, &QQuickItem::parentChanged, q, invalidateItems)
+                             << QObject::connect(item, &QObject::destroyed, q, invalidateItems);
+        m_tabItems.push_back(item);
+    }
+
+    m_tabItemsDirty = false;
+    return m_tabItems;
+}
+
+void QtQuick::TabBar::Private::ensureTabRects()
+{
+    tabItems();
+    if (!m_tabRectsDirty)
+        return;
+
+    m_tabRects.clear();
+    m_tabsSortedByX = true;
+
+    QQuickItem *parent = m_tabItems.isEmpty() ? nullptr : m_tabItems.constFirst()->parentItem();
+    for (const QPointer<QQuickItem> &item : std::as_const(m_tabItems)) {
+        const QRectF rect(item->position(), item->size());
+        if (item->parentItem() != parent || !parent
+            || (!m_tabRects.isEmpty() && rect.left() < m_tabRects.constLast().right()))
+            m_tabsSortedByX = false;
+
+        m_tabRects.push_back(rect);
+    }
+
+    m_tabRectsDirty = false;
+}
+
+int QtQuick::TabBar::Private::indexAt(QPointF globalPos)
+{
+    ensureTabRects();
+    if (m_tabRects.isEmpty())
+        return -1;
+
+    const auto contains = [](const QRectF &rect, QPointF pos) {
+        return pos.x() >= rect.left() && pos.x() < rect.right() && pos.y() >= rect.top()
+            && pos.y() < rect.bottom();
+    };
+
+    if (m_tabsSortedByX) {
+        // The usual case, tabs side by side in the same parent. A single mapping and a binary search.
+        const QPointF pos = m_tabItems.constFirst()->parentItem()->mapFromGlobal(globalPos);
+        auto it = std::upper_bound(m_tabRects.cbegin(), m_tabRects.cend(), pos.x(),
+                                   [](qreal x, const QRectF &rect) { return x < rect.left(); });
+        if (it == m_tabRects.cbegin())
+            return -1;
+
+        --it;
+        return contains(*it, pos) ? int(it - m_tabRects.cbegin()) : -1;
+    }
+
+    // Some custom layout, check each tab
+    for (int i = 0; i < m_tabItems.size(); ++i) {
+        QQuickItem *item = m_tabItems.at(i);
+        if (contains(QRectF(QPointF(0, 0), item->size()), item->mapFromGlobal(globalPos)))
+            return i;
+    }
+
+    return -1;
+}
+
 class DockWidgetModel::Private
 {
 public:
@@ -107,6 +258,11 @@ int TabBar::tabAt(QPoint localPt) const
 
     const QPointF globalPos = d->m_tabBarQmlItem->mapToGlobal(localPt);
 
+    const int cachedIndex = d->indexAt(globalPos);
+    if (cachedIndex != -1)
+        return cachedIndex;
+
+    // Not on a tab, let the QML decide, it might pick a default, like the current tab
     QVariant index;
     const bool res =
         QMetaObject::invokeMethod(d->m_tabBarQmlItem, "getTabIndexAtPosition",
@@ -131,6 +287,7 @@ void TabBar::setTabBarQmlItem(QQuickItem *item)
     }
 
     d->m_tabBarQmlItem = item;
+    d->invalidateTabItems();
     Q_EMIT tabBarQmlItemChanged();
 }
 
@@ -192,15 +349,11 @@ bool TabBar::event(QEvent *ev)
 
 QQuickItem *TabBar::tabAt(int index) const
 {
-    QVariant result;
-    const bool res = QMetaObject::invokeMethod(
-        d->m_tabBarQmlItem, "getTabAtIndex", Q_RETURN_ARG(QVariant, result), Q_ARG(QVariant, index));
-
-    if (res)
-        return result.value<QQuickItem *>();
+    const auto &items = d->tabItems();
+    if (index >= 0 && index < items.size())
+        return items.at(index);
 
-    qWarning() << Q_FUNC_INFO << "Could not find tab for index" << index;
-    return nullptr;
+    return d->qmlTabAt(index);
 }
 
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
@@ -279,14 +432,7 @@ void TabBar::onHoverEvent(QHoverEvent *ev, QPoint globalPos)
 
 int TabBar::indexForTabPos(QPoint globalPt) const
 {
-    const int count = d->m_dockWidgetModel->count();
-    for (int i = 0; i < count; i++) {
-        const QRect tabRect = globalRectForTab(i);
-        if (tabRect.contains(globalPt))
-            return i;
-    }
-
-    return -1;
+    return d->indexAt(globalPt);
 }
 
 void TabBar::setHoveredTabIndex(int idx)
@@ -722,10 +722,8 @@ int View::zOrder() const
 
 std::shared_ptr<Core::Window> View::window() const
 {
-    if (QWindow *w = QQuickItem::window()) {
-        auto windowqtquick = new QtQuick::Window(w);
-        return std::shared_ptr<Core::Window>(windowqtquick);
-    }
+    if (QWindow *w = QQuickItem::window())
+        return QtQuick::Platform::instance()->windowFromQWindow(w);
 
     return {};
 }
@@ -20,6 +20,7 @@
 #include "qtquick/views/RubberBand.h"
 #include "qtquick/views/View.h"
 #include "core/View_p.h"
+#include "qtquick/Platform.h"
 
 #include "qtquick/views/DockWidget.h"
 #include "qtquick/views/FloatingWindow.h"
@@ -160,10 +161,8 @@ std::shared_ptr<Core::View> ViewWrapper::childViewAt(QPoint p) const
 
 std::shared_ptr<Core::Window> ViewWrapper::window() const
 {
-    if (QWindow *w = m_item->window()) {
-        auto windowqtquick = new Window(w);
-        return std::shared_ptr<Core::Window>(windowqtquick);
-    }
+    if (QWindow *w = m_item->window())
+        return Platform::instance()->windowFromQWindow(w);
 
     return {};
 }
@@ -469,9 +468,15 @@ std::shared_ptr<Core::View> ViewWrapper::create(QQuickItem *item)
     if (!item)
         return {};
 
-    auto wrapper = new ViewWrapper(item);
-    auto sharedptr = std::shared_ptr<View>(wrapper);
-    wrapper->d->m_thisWeakPtr = sharedptr;
+    auto createWrapper = [item] {
+        auto wrapper = new ViewWrapper(item);
+        auto sharedptr = std::shared_ptr<View>(wrapper);
+        wrapper->d->m_thisWeakPtr = sharedptr;
+        return sharedptr;
+    };
+
+    if (!Core::Platform::hasInstance())
+        return createWrapper();
 
-    return sharedptr;
+    return QtCommon::Platform_qt::instance()->cachedViewWrapper(item, createWrapper);
 }
@@ -31,6 +31,7 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
+#include <QPlainTextEdit>
 #include <QLineEdit>
 #include <QSpinBox>
 #include <QMessageBox>
@@ -83,6 +84,40 @@ DebugAppEventFilter::~DebugAppEventFilter()
 {
 }
 
+static QString memoryUsageText(const DockRegistry::MemoryUsage &usage)
+{
+    QString text;
+    auto addEntry = [&text](const char *what, const DockRegistry::MemoryUsage::Entry &entry,
+                            int indent) {
+        text += QStringLiteral("%1%2: %3 (%4 bytes)\n")
+                    .arg(QString(indent, QLatin1Char(' ')), QString::fromLatin1(what))
+                    .arg(entry.count)
+                    .arg(qulonglong(entry.bytes));
+    };
+
+    for (const DockRegistry::MemoryUsage::LayoutUsage &layout : usage.layouts) {
+        const QString name = layout.mainWindowName.isEmpty()
+            ? QStringLiteral("FloatingWindow")
+            : QStringLiteral("MainWindow %1").arg(layout.mainWindowName);
+        text += QStringLiteral("%1: %2 bytes\n").arg(name).arg(qulonglong(layout.totalBytes()));
+        addEntry("Items", layout.items, 4);
+        addEntry("Placeholder items", layout.placeholderItems, 4);
+        addEntry("Separators", layout.separators, 4);
+        addEntry("Groups", layout.groups, 4);
+        addEntry("TitleBars", layout.titleBars, 4);
+        addEntry("TabBars", layout.tabBars, 4);
+    }
+
+    addEntry("FloatingWindows", usage.floatingWindows, 0);
+    addEntry("Drop indicator overlays", usage.dropIndicatorOverlays, 0);
+    addEntry("Positions", usage.positions, 0);
+    addEntry("LayoutSaver dock widgets", usage.savedDockWidgets, 0);
+    addEntry("Dock widget id remappings", usage.dockWidgetIdRemappings, 0);
+    text += QStringLiteral("Total: %1 bytes").arg(qulonglong(usage.totalBytes()));
+
+    return text;
+}
+
 DebugWindow::DebugWindow(QWidget *parent)
     : QWidget(parent)
     , m_objectViewer(this)
@@ -259,6 +294,18 @@ DebugWindow::DebugWindow(QWidget *parent)
     connect(button, &QPushButton::clicked, this, &DebugWindow::dumpWindows);
 #endif
 
+    button = new QPushButton(this);
+    button->setText(QStringLiteral("Memory usage"));
+    layout->addWidget(button);
+    auto memoryUsageView = new QPlainTextEdit(this);
+    memoryUsageView->setReadOnly(true);
+    memoryUsageView->setVisible(false);
+    layout->addWidget(memoryUsageView);
+    connect(button, &QPushButton::clicked, this, [memoryUsageView] {
+        memoryUsageView->setPlainText(memoryUsageText(DockRegistry::self()->memoryUsage()));
+        memoryUsageView->setVisible(true);
+    });
+
     resize(800, 800);
 }
 
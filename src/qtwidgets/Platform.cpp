@@ -127,7 +127,7 @@ std::shared_ptr<Core::View> Platform::qobjectAsView(QObject *obj) const
 std::shared_ptr<Core::Window> Platform::windowFromQWindow(QWindow *qwindow) const
 {
     Q_ASSERT(qwindow);
-    return std::shared_ptr<Core::Window>(new Window(qwindow));
+    return cachedWindowWrapper(qwindow, [qwindow] { return std::shared_ptr<Core::Window>(new Window(qwindow)); });
 }
 
 Core::ViewFactory *Platform::createDefaultViewFactory()
@@ -137,10 +137,8 @@ Core::ViewFactory *Platform::createDefaultViewFactory()
 
 Core::Window::Ptr Platform::windowAt(QPoint globalPos) const
 {
-    if (auto qwindow = qGuiApp->QGuiApplication::topLevelAt(globalPos)) {
-        auto window = new Window(qwindow);
-        return Core::Window::Ptr(window);
-    }
+    if (auto qwindow = qGuiApp->QGuiApplication::topLevelAt(globalPos))
+        return windowFromQWindow(qwindow);
 
     return {};
 }
@@ -11,6 +11,7 @@
 
 
 #include "Window_p.h"
+#include "Platform.h"
 #include "qtwidgets/views/ViewWrapper_p.h"
 
 #include <QWidget>
@@ -39,6 +40,20 @@ Window::Window(QWidget *topLevel)
     setProperty("kddockwidgets_qwidget", QVariant::fromValue<QWidget *>(topLevel));
 }
 
+/*static*/
+Core::Window::Ptr Window::forTopLevel(QWidget *topLevel)
+{
+    QWindow *window = windowForWidget(topLevel);
+    if (!window)
+        return {};
+
+    // The wrapper might have been created from the QWindow, which doesn't know its QWidget yet
+    if (window->property("kddockwidgets_qwidget").value<QWidget *>() != topLevel)
+        window->setProperty("kddockwidgets_qwidget", QVariant::fromValue<QWidget *>(topLevel));
+
+    return Platform::instance()->windowFromQWindow(window);
+}
+
 std::shared_ptr<Core::View> Window::rootView() const
 {
     if (!m_window)
@@ -54,7 +69,7 @@ std::shared_ptr<Core::View> Window::rootView() const
 Core::Window::Ptr Window::transientParent() const
 {
     if (QWindow *w = m_window->transientParent())
-        return Core::Window::Ptr(new QtWidgets::Window(w));
+        return Platform::instance()->windowFromQWindow(w);
 
     return nullptr;
 }
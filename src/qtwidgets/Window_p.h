@@ -24,6 +24,10 @@ public:
 
     explicit Window(QWidget *topLevel);
     ~Window() override;
+
+    /// Returns the cached wrapper for @p topLevel's QWindow, creating it if needed
+    static Window::Ptr forTopLevel(QWidget *topLevel);
+
     std::shared_ptr<Core::View> rootView() const override;
     Window::Ptr transientParent() const override;
     void setGeometry(QRect) override;
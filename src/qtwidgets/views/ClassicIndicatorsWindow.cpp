@@ -21,6 +21,7 @@
 #include <QPainter>
 
 #include <utility>
+#include <vector>
 
 #ifdef QT_X11EXTRAS_LIB
 #include <QtX11Extras/QX11Info>
@@ -66,10 +67,13 @@ public:
     QString iconName(bool active) const;
     QString iconFileName(bool active) const;
 
-    QImage m_image;
-    QImage m_imageActive;
+    /// Returns the decoded image, shared by all indicator windows
+    const QImage &image(bool active) const;
+
     bool m_hovered = false;
     const DropLocation m_dropLocation;
+    const QString m_fileName;
+    const QString m_fileNameActive;
 };
 
 static QString iconName(DropLocation loc, bool active)
@@ -120,10 +124,7 @@ static QString iconName(DropLocation loc, bool active)
 void Indicator::paintEvent(QPaintEvent *)
 {
     QPainter p(this);
-    if (m_hovered)
-        p.drawImage(rect(), m_imageActive, rect());
-    else
-        p.drawImage(rect(), m_image, rect());
+    p.drawImage(rect(), image(m_hovered));
 }
 
 void Indicator::setHovered(bool hovered)
@@ -149,6 +150,35 @@ QString Indicator::iconFileName(bool active) const
         : QStringLiteral("%1/opaque/%2.png").arg(path, name);
 }
 
+const QImage &Indicator::image(bool active) const
+{
+    // Every drop area has its own indicator window, so decode and scale each png only once per
+    // process, instead of once per window
+    struct Key
+    {
+        QString fileName;
+        qreal dpr;
+        bool operator==(const Key &other) const
+        {
+            return fileName == other.fileName && qFuzzyCompare(dpr, other.dpr);
+        }
+    };
+    static std::vector<std::pair<Key, QImage>> s_cache;
+
+    const Key key = { active ? m_fileNameActive : m_fileName, devicePixelRatioF() };
+    for (const auto &it : s_cache) {
+        if (it.first == key)
+            return it.second;
+    }
+
+    const int pixelWidth = qRound(INDICATOR_WIDTH * key.dpr);
+    QImage image = QImage(key.fileName).scaled(pixelWidth, pixelWidth);
+    image.setDevicePixelRatio(key.dpr);
+    s_cache.push_back({ key, image });
+
+    return s_cache.back().second;
+}
+
 static QWidget *parentForIndicatorWindow(ClassicDropIndicatorOverlay *classicIndicators_)
 {
     // On Wayland it can't be a top-level, as we have no way of positioning it
@@ -222,15 +252,27 @@ Indicator *IndicatorWindow::indicatorForLocation(DropLocation loc) const
 
 void IndicatorWindow::updateMask()
 {
-    QRegion region;
+    QVector<QRect> rects;
 
     if (!KDDockWidgets::windowManagerHasTranslucency()) {
+        rects.reserve(m_indicators.size());
         for (Indicator *indicator : std::as_const(m_indicators)) {
             if (indicator->isVisible())
-                region = region.united(QRegion(indicator->geometry(), QRegion::Rectangle));
+                rects.push_back(indicator->geometry());
         }
     }
 
+    // Setting a mask is expensive, as it goes to the window system, so only when it changes
+    if (m_maskInitialized && rects == m_maskRects)
+        return;
+
+    m_maskInitialized = true;
+    m_maskRects = rects;
+
+    QRegion region;
+    for (const QRect &rect : std::as_const(rects))
+        region = region.united(QRegion(rect, QRegion::Rectangle));
+
     setMask(region);
 }
 
@@ -293,6 +335,8 @@ void IndicatorWindow::updatePositions()
         m_bottom->move(m_center->pos() + QPoint(0, indicatorWidth + OUTTER_INDICATOR_MARGIN));
         m_left->move(m_center->pos() - QPoint(indicatorWidth + OUTTER_INDICATOR_MARGIN, 0));
     }
+
+    updateMask();
 }
 
 void IndicatorWindow::raise()
@@ -329,10 +373,10 @@ Indicator::Indicator(IndicatorWindow *parent,
                      DropLocation location)
     : QWidget(parent)
     , m_dropLocation(location)
+    , m_fileName(iconFileName(/*active=*/false))
+    , m_fileNameActive(iconFileName(/*active=*/true))
 {
-    m_image = QImage(iconFileName(/*active=*/false)).scaled(INDICATOR_WIDTH, INDICATOR_WIDTH);
-    m_imageActive = QImage(iconFileName(/*active=*/true)).scaled(INDICATOR_WIDTH, INDICATOR_WIDTH);
-    setFixedSize(m_image.size());
+    setFixedSize(INDICATOR_WIDTH, INDICATOR_WIDTH);
     setVisible(true);
 }
 
@@ -66,6 +66,10 @@ private:
     Indicator *const m_outterBottom;
     Indicator *const m_outterTop;
     QVector<Indicator *> m_indicators;
+
+    // The rects the current mask was built from
+    QVector<QRect> m_maskRects;
+    bool m_maskInitialized = false;
 };
 
 }
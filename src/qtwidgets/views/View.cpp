@@ -77,11 +77,8 @@ View<QLineEdit>::View(Core::Controller *controller, Core::ViewType type,
 template<class T>
 std::shared_ptr<Core::Window> View<T>::window() const
 {
-    if (QWidget *root = QWidget::window()) {
-        if (root->window()) {
-            return std::shared_ptr<Core::Window>(new Window(root));
-        }
-    }
+    if (QWidget *root = QWidget::window())
+        return Window::forTopLevel(root);
 
     return {};
 }
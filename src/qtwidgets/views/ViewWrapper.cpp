@@ -11,6 +11,7 @@
 
 #include "ViewWrapper_p.h"
 #include "core/View_p.h"
+#include "qtcommon/Platform.h"
 #include "qtwidgets/views/DockWidget.h"
 #include "qtwidgets/views/DropArea.h"
 #include "qtwidgets/views/FloatingWindow.h"
@@ -116,11 +117,17 @@ std::shared_ptr<Core::View> ViewWrapper::create(QWidget *widget)
     if (!widget)
         return {};
 
-    auto wrapper = new ViewWrapper(widget);
-    auto sharedptr = std::shared_ptr<View>(wrapper);
-    wrapper->d->m_thisWeakPtr = sharedptr;
+    auto createWrapper = [widget] {
+        auto wrapper = new ViewWrapper(widget);
+        auto sharedptr = std::shared_ptr<View>(wrapper);
+        wrapper->d->m_thisWeakPtr = sharedptr;
+        return sharedptr;
+    };
 
-    return sharedptr;
+    if (!Core::Platform::hasInstance())
+        return createWrapper();
+
+    return QtCommon::Platform_qt::instance()->cachedViewWrapper(widget, createWrapper);
 }
 
 ViewWrapper::ViewWrapper(QObject *widget)
@@ -157,7 +164,7 @@ void ViewWrapper::setGeometry(QRect rect)
 std::shared_ptr<Core::Window> ViewWrapper::window() const
 {
     if (m_widget->window()->windowHandle())
-        return std::shared_ptr<Core::Window>(new Window(m_widget->window()));
+        return Window::forTopLevel(m_widget->window());
 
     return nullptr;
 }
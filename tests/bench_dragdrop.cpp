@@ -0,0 +1,298 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/// Drag and drop latency benchmark.
+///
+/// Scripts a full drag: a floating window's title bar is pressed, the drag is started via
+/// DragController::programmaticStartDrag(), the cursor then visits every group of a main window
+/// and every floating window, and the window is finally dropped onto a drop indicator.
+///
+/// For every mouse move it reports latency percentiles for:
+///   - StateDragging::handleMouseMove() (the full move, what the user feels)
+///   - DragController::dropAreaUnderCursor()
+///   - DropArea::hover()
+///   - The event loop flush following the move, which is where indicators get painted
+///
+/// Runs with -platform offscreen by default. Use KDDW_TEST_FRONTEND=1 (QtWidgets) or
+/// KDDW_TEST_FRONTEND=2 (QtQuick) to benchmark a single frontend.
+///
+/// Example: bench_dragdrop --groups 64 --floating 16 --steps 20
+
+#include "utils.h"
+#include "core/DragController_p.h"
+#include "core/WindowBeingDragged_p.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Core;
+using namespace KDDockWidgets::Tests;
+
+namespace {
+
+struct Options
+{
+    int numGroups = 16;
+    int numFloating = 4;
+    int stepsPerTarget = 10;
+    int iterations = 3;
+};
+
+/// Holds the samples of a single metric, in nanoseconds
+struct Samples
+{
+    explicit Samples(const char *name)
+        : name(name)
+    {
+    }
+
+    void add(qint64 ns)
+    {
+        values.push_back(ns);
+    }
+
+    double percentileUs(double p) const
+    {
+        if (values.empty())
+            return 0;
+
+        const auto index = size_t(std::ceil(p / 100.0 * double(values.size()))) - 1;
+        return double(values[std::min(index, values.size() - 1)]) / 1000.0;
+    }
+
+    void print()
+    {
+        std::sort(values.begin(), values.end());
+
+        double sum = 0;
+        for (qint64 v : values)
+            sum += double(v);
+        const double mean = values.empty() ? 0 : sum / double(values.size()) / 1000.0;
+
+        std::printf("  %-22s n=%-6zu mean=%9.1fus p50=%9.1fus p90=%9.1fus p99=%9.1fus max=%9.1fus\n",
+                    name, values.size(), mean, percentileUs(50), percentileUs(90),
+                    percentileUs(99), percentileUs(100));
+    }
+
+    const char *const name;
+    std::vector<qint64> values;
+};
+
+template<typename Func>
+qint64 measure(Func &&func)
+{
+    QElapsedTimer timer;
+    timer.start();
+    func();
+    return timer.nsecsElapsed();
+}
+
+/// Nests @p numGroups dock widgets into a grid-like layout
+void populateMainWindow(Core::MainWindow *mainWindow, int numGroups)
+{
+    const int numColumns = std::max(1, int(std::ceil(std::sqrt(double(numGroups)))));
+    std::vector<Core::DockWidget *> columnHeads;
+
+    for (int i = 0; i < numGroups; ++i) {
+        auto dw = newDockWidget(QStringLiteral("bench-docked-%1").arg(i));
+        dw->setGuestView(Platform::instance()->tests_createView({ true, {}, { 50, 50 } })->asWrapper());
+
+        if (int(columnHeads.size()) < numColumns) {
+            mainWindow->addDockWidget(dw, Location_OnRight);
+            columnHeads.push_back(dw);
+        } else {
+            mainWindow->addDockWidget(dw, Location_OnBottom, columnHeads[size_t(i % numColumns)]);
+        }
+    }
+}
+
+std::vector<Core::FloatingWindow *> createFloatingWindows(int count, Point origin)
+{
+    std::vector<Core::FloatingWindow *> result;
+    result.reserve(size_t(count));
+
+    for (int i = 0; i < count; ++i) {
+        auto dw = createDockWidget(QStringLiteral("bench-floating-%1").arg(i));
+        auto fw = dw->floatingWindow();
+        fw->view()->window()->setGeometry(Rect(origin.x() + (i % 4) * 420, origin.y() + (i / 4) * 420, 400, 400));
+        result.push_back(fw);
+    }
+
+    return result;
+}
+
+/// Returns the list of cursor positions the drag will visit
+std::vector<Point> buildPath(Core::MainWindow *mainWindow,
+                             const std::vector<Core::FloatingWindow *> &floatingWindows,
+                             Point start, int stepsPerTarget)
+{
+    std::vector<Point> targets;
+    const auto groups = mainWindow->dropArea()->groups();
+    for (Core::Group *group : groups)
+        targets.push_back(group->view()->mapToGlobal(group->view()->rect().center()));
+
+    for (Core::FloatingWindow *fw : floatingWindows)
+        targets.push_back(fw->view()->mapToGlobal(fw->view()->rect().center()));
+
+    std::vector<Point> path;
+    path.reserve(targets.size() * size_t(stepsPerTarget));
+    Point previous = start;
+    for (Point target : targets) {
+        for (int step = 1; step <= stepsPerTarget; ++step) {
+            const double ratio = double(step) / stepsPerTarget;
+            path.push_back(Point(previous.x() + int((target.x() - previous.x()) * ratio),
+                                 previous.y() + int((target.y() - previous.y()) * ratio)));
+        }
+        previous = target;
+    }
+
+    return path;
+}
+
+bool runDrag(const Options &opts, Samples &moveSamples, Samples &dropAreaSamples,
+             Samples &hoverSamples, Samples &paintSamples, Samples &dropSamples)
+{
+    EnsureTopLevelsDeleted e;
+    auto dc = DragController::instance();
+
+    const int numColumns = std::max(1, int(std::ceil(std::sqrt(double(opts.numGroups)))));
+    const Size mainWindowSize(std::max(1000, numColumns * 120), std::max(800, numColumns * 120));
+    auto mainWindow = createMainWindow(mainWindowSize, MainWindowOption_None, QStringLiteral("bench-mainwindow"));
+    populateMainWindow(mainWindow.get(), opts.numGroups);
+
+    const Rect mainWindowGeo = mainWindow->view()->window()->geometry();
+    const auto floatingWindows = createFloatingWindows(
+        opts.numFloating, Point(mainWindowGeo.right() + 50, mainWindowGeo.top()));
+
+    auto draggedDock = createDockWidget(QStringLiteral("bench-dragged"));
+    Core::FloatingWindow *draggedWindow = draggedDock->floatingWindow();
+    draggedWindow->view()->window()->setGeometry(Rect(mainWindowGeo.left(), mainWindowGeo.bottom() + 50, 400, 400));
+    Platform::instance()->tests_wait(100);
+
+    // programmaticStartDrag() simulates the press on the title bar and the move that crosses
+    // startDragDistance(), through the same state machine path as a real mouse
+    Core::TitleBar *titleBar = draggedWindow->titleBar();
+    const Point pressPos = titleBar->view()->mapToGlobal(Point(10, 10));
+    const int dragDistance = Platform::instance()->startDragDistance();
+    const Point startPos = pressPos + Point(dragDistance + 1, 0);
+    Platform::instance()->setCursorPos(startPos);
+    if (!dc->programmaticStartDrag(titleBar, startPos, Point(10, 10))) {
+        std::fprintf(stderr, "Failed to start drag\n");
+        return false;
+    }
+
+    const std::vector<Point> path = buildPath(mainWindow.get(), floatingWindows, startPos, opts.stepsPerTarget);
+    for (Point pos : path) {
+        if (!dc->isDragging()) {
+            std::fprintf(stderr, "Drag was canceled unexpectedly\n");
+            return false;
+        }
+
+        Platform::instance()->setCursorPos(pos);
+        moveSamples.add(measure([dc, pos] { dc->activeState()->handleMouseMove(pos); }));
+
+        // Now measure the individual steps of handleMouseMove(). They are idempotent for the same
+        // cursor position, so running them again doesn't change the state of the drag.
+        Core::DropArea *dropArea = nullptr;
+        dropAreaSamples.add(measure([dc, &dropArea] { dropArea = dc->dropAreaUnderCursor(); }));
+        if (dropArea) {
+            WindowBeingDragged *wbd = dc->windowBeingDragged();
+            hoverSamples.add(measure([dropArea, wbd, pos] { dropArea->hover(wbd, pos); }));
+        }
+
+        paintSamples.add(measure([] { QCoreApplication::processEvents(); }));
+    }
+
+    // Finally drop into the main window's outer left drop indicator
+    const Point center = mainWindow->view()->mapToGlobal(mainWindow->view()->rect().center());
+    Platform::instance()->setCursorPos(center);
+    dc->activeState()->handleMouseMove(center);
+    QCoreApplication::processEvents();
+
+    const Point dropPos = mainWindow->dropArea()->dropIndicatorOverlay()->posForIndicator(DropLocation_OutterLeft);
+    Platform::instance()->setCursorPos(dropPos);
+    dc->activeState()->handleMouseMove(dropPos);
+    dropSamples.add(measure([dc, dropPos] { dc->activeState()->handleMouseButtonRelease(dropPos); }));
+
+    return !dc->isDragging();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QStringList args;
+    for (int i = 0; i < argc; ++i)
+        args << QString::fromLocal8Bit(argv[i]);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("KDDockWidgets drag and drop latency benchmark"));
+    parser.addHelpOption();
+    QCommandLineOption groupsOption(QStringLiteral("groups"), QStringLiteral("Number of groups docked in the main window"), QStringLiteral("N"), QStringLiteral("16"));
+    QCommandLineOption floatingOption(QStringLiteral("floating"), QStringLiteral("Number of floating windows"), QStringLiteral("M"), QStringLiteral("4"));
+    QCommandLineOption stepsOption(QStringLiteral("steps"), QStringLiteral("Mouse moves between two consecutive targets"), QStringLiteral("steps"), QStringLiteral("10"));
+    QCommandLineOption iterationsOption(QStringLiteral("iterations"), QStringLiteral("How many times to repeat the whole drag"), QStringLiteral("count"), QStringLiteral("3"));
+    parser.addOptions({ groupsOption, floatingOption, stepsOption, iterationsOption });
+
+    // Parse before the QApplication exists, as Platform creates it
+    if (!parser.parse(args)) {
+        std::fprintf(stderr, "%s\n", qPrintable(parser.errorText()));
+        return 1;
+    }
+
+    if (parser.isSet(QStringLiteral("help"))) {
+        std::printf("%s\n", qPrintable(parser.helpText()));
+        return 0;
+    }
+
+    Options opts;
+    opts.numGroups = std::max(1, parser.value(groupsOption).toInt());
+    opts.numFloating = std::max(0, parser.value(floatingOption).toInt());
+    opts.stepsPerTarget = std::max(1, parser.value(stepsOption).toInt());
+    opts.iterations = std::max(1, parser.value(iterationsOption).toInt());
+
+    const auto frontends = Platform::frontendTypes();
+    for (auto frontend : frontends) {
+        Platform::tests_initPlatform(argc, argv, frontend);
+
+        Samples moveSamples("handleMouseMove");
+        Samples dropAreaSamples("dropAreaUnderCursor");
+        Samples hoverSamples("DropArea::hover");
+        Samples paintSamples("event loop / painting");
+        Samples dropSamples("drop");
+
+        for (int i = 0; i < opts.iterations; ++i) {
+            if (!runDrag(opts, moveSamples, dropAreaSamples, hoverSamples, paintSamples, dropSamples)) {
+                Platform::tests_deinitPlatform();
+                return 1;
+            }
+        }
+
+        std::printf("%s: groups=%d floating=%d steps=%d iterations=%d\n",
+                    Platform::instance()->name(), opts.numGroups, opts.numFloating,
+                    opts.stepsPerTarget, opts.iterations);
+        moveSamples.print();
+        dropAreaSamples.print();
+        hoverSamples.print();
+        paintSamples.print();
+        dropSamples.print();
+
+        Platform::tests_deinitPlatform();
+    }
+
+    return 0;
+}
@@ -20,7 +20,10 @@
 #include "qtquick/views/DockWidget.h"
 #include "qtquick/views/MainWindow.h"
 #include "qtquick/views/FloatingWindow.h"
+#include "qtquick/views/TabBar.h"
 #include "core/MDILayout.h"
+#include "core/Group.h"
+#include "core/TabBar.h"
 #include "core/views/MainWindowViewInterface.h"
 #include "core/MainWindow.h"
 #include "core/Window_p.h"
@@ -69,6 +72,7 @@ private Q_SLOTS:
     void tst_deleteDockWidget();
     void tst_setViewFactory();
     void tst_quickWindowCreationCallback();
+    void tst_tabBarHitTesting();
 };
 
 
@@ -557,6 +561,52 @@ void TestQtQuick::tst_quickWindowCreationCallback()
     QtQuick::FloatingWindow::setQuickWindowCreationCallback(nullptr);
 }
 
+void TestQtQuick::tst_tabBarHitTesting()
+{
+    // Tests that the cached tab geometry follows tabs being added and removed
+    EnsureTopLevelsDeleted e;
+    QQmlApplicationEngine engine(":/main2.qml");
+
+    auto dock0 = createDockWidget(
+        "dock0", Platform::instance()->tests_createView({ true, {}, QSize(400, 400) }));
+    const auto mainWindows = DockRegistry::self()->mainwindows();
+    MainWindow *m = mainWindows.first();
+    m->addDockWidget(dock0, Location_OnLeft);
+
+    for (int i = 1; i < 4; ++i)
+        dock0->addDockWidgetAsTab(createDockWidget(
+            QString("dock%1").arg(i), Platform::instance()->tests_createView({ true, {}, QSize(400, 400) })));
+
+    Core::Group *group = dock0->dptr()->group();
+    auto tabBar = static_cast<QtQuick::TabBar *>(group->tabBar()->view());
+
+    auto verifyTabs = [tabBar, group] {
+        QTest::qWait(100);
+        const int count = group->dockWidgetCount();
+        for (int i = 0; i < count; ++i) {
+            const QRect rect = tabBar->globalRectForTab(i);
+            if (rect.isEmpty())
+                return false;
+
+            if (tabBar->indexForTabPos(rect.center()) != i)
+                return false;
+        }
+
+        return tabBar->indexForTabPos(tabBar->globalRectForTab(count - 1).topRight() + QPoint(100, 0)) == -1;
+    };
+
+    QVERIFY(verifyTabs());
+
+    dock0->addDockWidgetAsTab(createDockWidget(
+        "dock4", Platform::instance()->tests_createView({ true, {}, QSize(400, 400) })));
+    QCOMPARE(group->dockWidgetCount(), 5);
+    QVERIFY(verifyTabs());
+
+    DockRegistry::self()->dockByName("dock2")->close();
+    QCOMPARE(group->dockWidgetCount(), 4);
+    QVERIFY(verifyTabs());
+}
+
 int main(int argc, char *argv[])
 {
 #ifdef KDDW_HAS_SPDLOG
@@ -16,10 +16,13 @@
 #include "core/DragController_p.h"
 #include "utils.h"
 #include "core/LayoutSaver_p.h"
+#include "LayoutAutoSaver.h"
+#include "Tracing.h"
 #include "core/ScopedValueRollback_p.h"
 #include "core/Position_p.h"
 #include "core/TitleBar_p.h"
 #include "core/TabBar_p.h"
+#include "core/Group_p.h"
 #include "core/Action_p.h"
 #include "core/WindowBeingDragged_p.h"
 #include "core/Logging_p.h"
@@ -33,6 +36,7 @@
 #include "core/MainWindow.h"
 #include "core/DockWidget.h"
 #include "core/DockWidget_p.h"
+#include "core/AffinitySet_p.h"
 #include "core/Separator.h"
 #include "core/TabBar.h"
 #include "core/Stack.h"
@@ -41,7 +45,10 @@
 
 #include <QTest>
 
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -80,10 +87,12 @@ private Q_SLOTS:
     void tst_hasPreviousDockedLocation();
     void tst_hasPreviousDockedLocation2();
     void tst_LayoutSaverOpenedDocks();
+    void tst_layoutSaverDiff();
     void tst_ghostSeparator();
     void tst_detachFromMainWindow();
     void tst_floatingWindowSize();
     void tst_tabbingWithAffinities();
+    void tst_affinitySet();
     void tst_floatingWindowTitleBug();
     void tst_setFloatingSimple();
     void tst_dragOverTitleBar();
@@ -106,6 +115,7 @@ private Q_SLOTS:
     void tst_restoreWithNewDockWidgets();
     void tst_restoreWithDockFactory();
     void tst_restoreWithDockFactory2();
+    void tst_restoreWithDockBatchFactory();
     void tst_dontCloseDockWidgetBeforeRestore();
     void tst_dontCloseDockWidgetBeforeRestore3();
     void tst_dontCloseDockWidgetBeforeRestore4();
@@ -130,6 +140,11 @@ private Q_SLOTS:
     void tst_setAsCurrentTab();
     void tst_placeholderDisappearsOnReadd();
     void tst_placeholdersAreRemovedProperly();
+    void tst_maxPlaceholdersPerLayout();
+    void tst_dropIndicatorOverlayLifetime();
+    void tst_layoutAsync();
+    void tst_topLevelZOrder();
+    void tst_memoryUsage();
     void tst_closeAllDockWidgets();
     void tst_toggleMiddleDockCrash();
     void tst_stealFrame();
@@ -209,6 +224,11 @@ private Q_SLOTS:
     void tst_lastFloatingPositionIsRestored();
     void tst_restoreNonClosable();
     void tst_restoreNlohmanException();
+    void tst_layoutJsonRoundTrip();
+    void tst_layoutAutoSaver();
+    void tst_traceSink();
+    void tst_batchInsertion();
+    void tst_tabSwitchWithSameConstraints();
     void tst_restoreWithInvalidCurrentTab();
     void tst_restoreRestoresMainWindowPosition();
     void tst_dontCloseDockWidgetBeforeRestore2();
@@ -216,6 +236,7 @@ private Q_SLOTS:
     void tst_doubleClickTabBarRestore();
     void tst_doubleClickTabRestore();
     void tst_tabTitleChanges();
+    void tst_coalescedTitleChanges();
     void tst_preventClose();
     void tst_addAndReadd();
     void tst_notClosable();
@@ -490,6 +511,51 @@ void TestDocks::tst_LayoutSaverOpenedDocks()
     QVERIFY(LayoutSaver::openedDockWidgetsInLayout(saved2) == Vector<QString>({ "1", "2" }));
 }
 
+void TestDocks::tst_layoutSaverDiff()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("1");
+    auto dock2 = createDockWidget("2");
+    auto dock3 = createDockWidget("3");
+    m->addDockWidget(dock1, KDDockWidgets::Location_OnLeft);
+    m->addDockWidget(dock2, KDDockWidgets::Location_OnRight);
+    dock3->close();
+
+    LayoutSaver saver;
+    const QByteArray saved1 = saver.serializeLayout();
+    QVERIFY(LayoutSaver::diffLayouts(saved1, saved1).isEmpty());
+    QVERIFY(saver.diffWithCurrentLayout(saved1).isEmpty());
+
+    dock2->addDockWidgetAsTab(dock3);
+    const QByteArray saved2 = saver.serializeLayout();
+
+    auto diff = LayoutSaver::diffLayouts(saved1, saved2);
+    QVERIFY(diff.isValid);
+    QVERIFY(!diff.isEmpty());
+    QCOMPARE(diff.openedDockWidgets, Vector<QString>({ "3" }));
+    QVERIFY(diff.closedDockWidgets.isEmpty());
+    QCOMPARE(diff.movedDockWidgets, Vector<QString>({ "2" })); // Now tabbed with 3
+    QVERIFY(diff.resizedDockWidgets.isEmpty());
+
+    diff = saver.diffWithCurrentLayout(saved1);
+    QCOMPARE(diff.closedDockWidgets, Vector<QString>({ "3" }));
+    QCOMPARE(diff.movedDockWidgets, Vector<QString>({ "2" }));
+
+    // Moving a floating window doesn't move its dock widgets, only the window changes
+    dock1->setFloating(true);
+    auto fw = dock1->floatingWindow();
+    QVERIFY(fw);
+    const QByteArray saved3 = saver.serializeLayout();
+    fw->view()->move(fw->x() + 50, fw->y() + 50);
+
+    diff = saver.diffWithCurrentLayout(saved3);
+    QVERIFY(diff.movedDockWidgets.isEmpty());
+    QVERIFY(diff.resizedDockWidgets.isEmpty());
+    QCOMPARE(diff.changedFloatingWindows.size(), 1);
+    QCOMPARE(diff.changedFloatingWindows.first(), Vector<QString>({ "1" }));
+}
+
 void TestDocks::tst_ghostSeparator()
 {
     // Tests a situation where a separator wouldn't be removed after a widget had been removed
@@ -624,6 +690,56 @@ void TestDocks::tst_tabbingWithAffinities()
     delete fw2;
 }
 
+void TestDocks::tst_affinitySet()
+{
+    // AffinitySet must match exactly like the string based DockRegistry::affinitiesMatch() did
+    const AffinitySet empty;
+    const AffinitySet af1({ "af1" });
+    const AffinitySet af12({ "af1", "af2" });
+    const AffinitySet af3({ "af3" });
+
+    QVERIFY(empty.isEmpty());
+    QVERIFY(!empty.matches(AffinitySet({ QString() })));
+    QVERIFY(AffinitySet({ QString() }).matches(AffinitySet({ QString() })));
+    QVERIFY(!DockRegistry::self()->affinitiesMatch({ QString() }, {}));
+
+    // Strings from the public API aren't interned
+    const QString neverInterned = QStringLiteral("tst_affinitySet_never_interned");
+    QVERIFY(DockRegistry::self()->affinitiesMatch({ neverInterned }, { neverInterned }));
+    QVERIFY(DockRegistry::self()->mainWindowsWithAffinity({ neverInterned }).isEmpty());
+    QVERIFY(!AffinitySet::lookup({ neverInterned }).isEmpty());
+    QVERIFY(!AffinitySet::lookup({ neverInterned }).matches(empty));
+    QCOMPARE(StringTable::affinities()->idFor(neverInterned), -1);
+    QVERIFY(empty.matches(empty));
+    QVERIFY(!empty.matches(af1));
+    QVERIFY(af1.matches(af12));
+    QVERIFY(af12.matches(af1));
+    QVERIFY(!af1.matches(af3));
+    QVERIFY(AffinitySet({ "af2", "af1" }) == af12);
+
+    // Ids beyond the first 64 bits
+    Vector<QString> many;
+    for (int i = 0; i < 200; ++i)
+        many.push_back(QStringLiteral("tst_affinitySet-%1").arg(i));
+    const AffinitySet manySet(many);
+    QVERIFY(manySet.matches(AffinitySet({ many.last() })));
+    QVERIFY(!manySet.matches(af3));
+    QVERIFY(!AffinitySet({ many.last() }).matches(AffinitySet({ many.at(150) })));
+
+    // Affinities have their own table, dock widget names don't push their ids past the first word
+    QVERIFY(StringTable::affinities()->idFor(QStringLiteral("af1")) < 64);
+    QCOMPARE(StringTable::affinities()->idFor(QStringLiteral("tst_affinitySet")), -1);
+
+    // Interned names
+    auto dw = newDockWidget(QStringLiteral("tst_affinitySet"));
+    QCOMPARE(StringTable::self()->stringFor(dw->dptr()->uniqueNameId()), QStringLiteral("tst_affinitySet"));
+    QCOMPARE(DockRegistry::self()->dockByName(QStringLiteral("tst_affinitySet")), dw);
+    QVERIFY(!DockRegistry::self()->dockByName(QStringLiteral("tst_affinitySet_never_interned")));
+    dw->setAffinities({ "af1" });
+    QVERIFY(affinitySetOf(dw) == af1);
+    delete dw;
+}
+
 void TestDocks::tst_sizeAfterRedock()
 {
     EnsureTopLevelsDeleted e;
@@ -784,6 +900,241 @@ void TestDocks::tst_restoreNlohmanException()
     QVERIFY(layout.fromJson(data));
 }
 
+void TestDocks::tst_layoutJsonRoundTrip()
+{
+    // Layout::toJson() streams and Layout::fromJson() uses a SAX parser. Check they are still
+    // compatible with what the json DOM would produce
+    for (const char *filename : { ":/layouts/minimizeBug.json", ":/layouts/sidebar_restore.json",
+                                  ":/layouts/1.6layoutWithoutFloatingWindowFlags.json" }) {
+        bool ok = false;
+        const QByteArray data = Platform::instance()->readFile(filename, /*by-ref*/ ok);
+        QVERIFY(ok);
+
+        QByteArray serialized;
+        {
+            LayoutSaver::Layout layout;
+            QVERIFY(layout.fromJson(data));
+            serialized = layout.toJson();
+        }
+
+        const nlohmann::json dom = nlohmann::json::parse(serialized.constData(), nullptr, /*allow_exceptions=*/false);
+        QVERIFY(!dom.is_discarded());
+        QCOMPARE(serialized, QByteArray::fromStdString(dom.dump(4)));
+
+        LayoutSaver::Layout layout;
+        QVERIFY(layout.fromJson(serialized));
+        QCOMPARE(layout.toJson(), serialized);
+    }
+
+    LayoutSaver::Layout layout;
+    QVERIFY(!layout.fromJson("[]"));
+    QVERIFY(!layout.fromJson("{ \"mainWindows\": 1 }"));
+    QVERIFY(!layout.fromJson("{ \"mainWindows\": [ ] } trailing"));
+    QVERIFY(layout.fromJson("{}"));
+    QCOMPARE(layout.serializationVersion, 0);
+}
+
+void TestDocks::tst_layoutAutoSaver()
+{
+    EnsureTopLevelsDeleted e;
+    const QString journal = QStringLiteral("layout_tst_layoutAutoSaver.journal");
+
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_layoutAutoSaver");
+    auto dock1 = createDockWidget("1");
+    auto dock2 = createDockWidget("2");
+    auto dock3 = createDockWidget("3");
+    m->addDockWidget(dock1, Location_OnLeft);
+
+    {
+        LayoutAutoSaver autoSaver(journal);
+
+        // The first flush is a snapshot
+        autoSaver.flush();
+        QCOMPARE(autoSaver.numDeltas(), 0);
+
+        // Nothing changed, nothing to write
+        autoSaver.flush();
+        QCOMPARE(autoSaver.numDeltas(), 0);
+
+        m->addDockWidget(dock2, Location_OnRight);
+        autoSaver.flush();
+        QCOMPARE(autoSaver.numDeltas(), 1);
+
+        dock3->close();
+        autoSaver.flush();
+        QCOMPARE(autoSaver.numDeltas(), 2);
+
+        autoSaver.waitForWrites();
+
+        LayoutSaver saver;
+        const QByteArray expected = saver.serializeLayout();
+        const QByteArray recovered = LayoutAutoSaver::layoutFromJournal(journal);
+        QCOMPARE(LayoutSaver::openedDockWidgetsInLayout(recovered), LayoutSaver::openedDockWidgetsInLayout(expected));
+
+        // Compacting leaves a single snapshot, with the same content
+        autoSaver.compact();
+        QCOMPARE(autoSaver.numDeltas(), 0);
+        autoSaver.waitForWrites();
+        QCOMPARE(LayoutAutoSaver::layoutFromJournal(journal), recovered);
+    }
+
+    // If replacing the journal with a new snapshot failed, the snapshot is recovered instead
+    const QString tmpJournal = journal + QStringLiteral(".tmp");
+    QCOMPARE(std::rename(journal.toStdString().c_str(), tmpJournal.toStdString().c_str()), 0);
+    QVERIFY(!LayoutAutoSaver::layoutFromJournal(journal).isEmpty());
+    QCOMPARE(std::rename(tmpJournal.toStdString().c_str(), journal.toStdString().c_str()), 0);
+
+    // Mess the layout up and recover it
+    dock1->close();
+    dock2->setFloating(true);
+    dock3->open();
+
+    QVERIFY(LayoutAutoSaver::restoreFromJournal(journal));
+    QVERIFY(dock1->isOpen());
+    QVERIFY(dock2->isOpen());
+    QVERIFY(!dock3->isOpen());
+    QVERIFY(!dock2->isFloating());
+    QVERIFY(dock1->isInMainWindow());
+    QVERIFY(dock2->isInMainWindow());
+
+    std::remove(journal.toStdString().c_str());
+}
+
+void TestDocks::tst_traceSink()
+{
+    EnsureTopLevelsDeleted e;
+    const QString filename = QStringLiteral("tst_traceSink.json");
+
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "tst_traceSink");
+    auto dock1 = createDockWidget("1");
+    m->addDockWidget(dock1, Location_OnLeft);
+
+    int numEvents = 0;
+    {
+        // The sink also flushes when destroyed, so scope it before removing the file
+        ChromeTraceFileSink sink(filename);
+        TraceSink::setCurrent(&sink);
+        dock1->setFloating(true);
+        TraceSink::setCurrent(nullptr);
+
+        // Not traced, as the sink was unset
+        dock1->setFloating(false);
+        numEvents = sink.numEvents();
+        QCOMPARE(numEvents > 0, TraceSink::isCompiledIn());
+
+        TraceEvent instant;
+        instant.name = "instant";
+        instant.category = "test";
+        sink.addEvent(instant);
+        QVERIFY(sink.flush());
+    }
+
+    std::ifstream file(filename.toStdString());
+    QVERIFY(file.is_open());
+    const nlohmann::json dom = nlohmann::json::parse(file, nullptr, /*allow_exceptions=*/false);
+    file.close();
+    std::remove(filename.toStdString().c_str());
+    QVERIFY(!dom.is_discarded());
+
+    const nlohmann::json &events = dom["traceEvents"];
+    QCOMPARE(int(events.size()), numEvents + 1);
+    QCOMPARE(events.back()["ph"].get<std::string>(), std::string("i"));
+
+    if (TraceSink::isCompiledIn()) {
+        const auto it = std::find_if(events.begin(), events.end(), [](const nlohmann::json &event) {
+            return event["name"] == "DockWidget::setFloating";
+        });
+        QVERIFY(it != events.end());
+        QCOMPARE((*it)["ph"].get<std::string>(), std::string("X"));
+    }
+}
+
+void TestDocks::tst_batchInsertion()
+{
+    EnsureTopLevelsDeleted e;
+
+    // m1 is built in a batch, m2 isn't. They must end up the same.
+    auto m1 = createMainWindow(Size(1000, 800), MainWindowOption_None, "tst_batchInsertion1");
+    auto m2 = createMainWindow(Size(1000, 800), MainWindowOption_None, "tst_batchInsertion2");
+
+    const auto buildLayout = [](Core::MainWindow *m, const QString &prefix) {
+        Vector<Core::DockWidget *> docks;
+        for (int i = 0; i < 12; ++i) {
+            auto dock = createDockWidget(prefix + QString::number(i));
+            Core::DockWidget *relativeTo = i > 3 ? docks.at(i - 3) : nullptr;
+            m->addDockWidget(dock, i % 2 == 0 ? Location_OnRight : Location_OnBottom, relativeTo);
+            docks.push_back(dock);
+        }
+        return docks;
+    };
+
+    m1->beginBatchInsertion();
+    const Vector<Core::DockWidget *> docks1 = buildLayout(m1.get(), QStringLiteral("batch-"));
+
+    // Separators are only created at the end
+    QVERIFY(m1->multiSplitter()->rootItem()->isInBatch());
+    QCOMPARE(m1->multiSplitter()->separators().size(), 0);
+    QVERIFY(m1->multiSplitter()->checkSanity());
+    QVERIFY(DockRegistry::self()->isSane());
+    m1->endBatchInsertion();
+    QVERIFY(!m1->multiSplitter()->rootItem()->isInBatch());
+
+    const Vector<Core::DockWidget *> docks2 = buildLayout(m2.get(), QStringLiteral("nobatch-"));
+
+    QCOMPARE(m1->multiSplitter()->separators().size(), m2->multiSplitter()->separators().size());
+    QVERIFY(m1->multiSplitter()->checkSanity());
+
+    for (int i = 0; i < docks1.size(); ++i) {
+        Core::Group *group1 = docks1.at(i)->dptr()->group();
+        Core::Group *group2 = docks2.at(i)->dptr()->group();
+        QCOMPARE(group1->view()->geometry(), group2->view()->geometry());
+        QCOMPARE(group1->view()->geometry(), group1->layoutItem()->mapToRoot(group1->layoutItem()->rect()));
+        QCOMPARE(group1->titleBar()->isVisible(), group2->titleBar()->isVisible());
+    }
+}
+
+void TestDocks::tst_tabSwitchWithSameConstraints()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("1");
+    auto dock2 = createDockWidget("2");
+    auto dock3 = createDockWidget("3");
+    dock3->view()->setMinimumSize(Size(300, 300));
+
+    m->addDockWidget(dock1, Location_OnLeft);
+    dock1->addDockWidgetAsTab(dock2);
+    dock1->addDockWidgetAsTab(dock3);
+    Platform::instance()->tests_wait(100);
+
+    Core::Group *group = dock1->dptr()->group();
+    Core::Group::Private *groupPrivate = group->dptr();
+    QCOMPARE(group->currentDockWidget(), dock3);
+    QVERIFY(!groupPrivate->m_switchingTabsWithSameConstraints);
+
+    // dock3 has different constraints, so the layout is told about it as usual
+    group->setCurrentDockWidget(dock1);
+    QVERIFY(!groupPrivate->m_switchingTabsWithSameConstraints);
+
+    // Same constraints, the layout isn't disturbed until the next event loop iteration
+    group->setCurrentDockWidget(dock2);
+    QVERIFY(groupPrivate->m_switchingTabsWithSameConstraints);
+    Platform::instance()->tests_wait(100);
+    QVERIFY(!groupPrivate->m_switchingTabsWithSameConstraints);
+
+    QVERIFY(group->view()->width() >= 300);
+    QVERIFY(m->multiSplitter()->checkSanity());
+
+    // Unrelated constraint changes during the switch aren't lost
+    group->setCurrentDockWidget(dock1);
+    QVERIFY(groupPrivate->m_switchingTabsWithSameConstraints);
+    dock2->view()->setMinimumSize(Size(400, 400));
+    Platform::instance()->tests_wait(100);
+    QVERIFY(!groupPrivate->m_switchingTabsWithSameConstraints);
+    QVERIFY(group->layoutItem()->minSize().width() >= 400);
+    QVERIFY(m->multiSplitter()->checkSanity());
+}
+
 void TestDocks::tst_restoreEmpty()
 {
     EnsureTopLevelsDeleted e;
@@ -1770,6 +2121,207 @@ void TestDocks::tst_placeholdersAreRemovedProperly()
     layout->checkSanity();
 }
 
+void TestDocks::tst_maxPlaceholdersPerLayout()
+{
+    EnsureTopLevelsDeleted e;
+    Config::self().setMaxPlaceholdersPerLayout(2);
+
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None);
+    Core::DropArea *layout = m->multiSplitter();
+    Core::DockWidget::List docks;
+    for (int i = 0; i < 4; ++i) {
+        auto dock = createDockWidget(QString::number(i), Platform::instance()->tests_createView({ true }));
+        m->addDockWidget(dock, Location_OnRight);
+        docks.push_back(dock);
+    }
+
+    docks[1]->close();
+    docks[0]->close();
+    docks[2]->close();
+    QCOMPARE(layout->placeholderCount(), 3);
+
+    // dock1 was closed first, so its placeholder goes
+    layout->collectPlaceholders();
+    QCOMPARE(layout->placeholderCount(), 2);
+    QCOMPARE(layout->evictedPlaceholderCount(), 1);
+    QCOMPARE(docks[1]->dptr()->lastPosition()->placeholderCount(), 0);
+    QCOMPARE(docks[0]->dptr()->lastPosition()->placeholderCount(), 1);
+    QCOMPARE(docks[2]->dptr()->lastPosition()->placeholderCount(), 1);
+    QVERIFY(layout->checkSanity());
+
+    // Within budget, nothing to do
+    layout->collectPlaceholders();
+    QCOMPARE(layout->evictedPlaceholderCount(), 1);
+
+    // Dock widgets still open fine, with or without placeholder
+    docks[1]->open();
+    docks[0]->open();
+    QVERIFY(docks[1]->isOpen());
+    QVERIFY(docks[0]->isOpen());
+    QCOMPARE(layout->placeholderCount(), 1);
+    QVERIFY(layout->checkSanity());
+}
+
+void TestDocks::tst_dropIndicatorOverlayLifetime()
+{
+    EnsureTopLevelsDeleted e;
+    auto m1 = createMainWindow(Size(800, 500), MainWindowOption_None);
+    auto m2 = createMainWindow(Size(800, 500), MainWindowOption_None);
+
+    // Created on demand
+    ObjectGuard<Core::DropIndicatorOverlay> overlay1 = m1->dropArea()->dropIndicatorOverlay();
+    QVERIFY(overlay1);
+
+    // Kept while hovering other drop areas during the same drag
+    ObjectGuard<Core::DropIndicatorOverlay> overlay2 = m2->dropArea()->dropIndicatorOverlay();
+    QVERIFY(overlay2);
+    QVERIFY(overlay1);
+    QCOMPARE(m1->dropArea()->dropIndicatorOverlay(), overlay1.data());
+
+    // Deleted once the drag ends
+    Core::DropArea::deleteDropIndicatorOverlays();
+    QVERIFY(!overlay1);
+    QVERIFY(!overlay2);
+    QVERIFY(!m1->dropArea()->hasDropIndicatorOverlay());
+
+    // And created again when needed
+    QVERIFY(m1->dropArea()->dropIndicatorOverlay());
+}
+
+void TestDocks::tst_layoutAsync()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("1");
+    auto dock2 = createDockWidget("2");
+    auto dock3 = createDockWidget("3");
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    m->addDockWidget(dock3, Location_OnBottom, dock2);
+
+    Core::DropArea *dropArea = m->dropArea();
+    const auto waitFor = [](const bool &done) {
+        for (int i = 0; i < 200 && !done; ++i)
+            Platform::instance()->tests_wait(10);
+        return done;
+    };
+
+    // Same result as layoutEqually(), applied later, via runDelayed()
+    bool done = false;
+    dropArea->layoutEquallyAsync([&done] { done = true; });
+    QVERIFY(!done);
+    QVERIFY(waitFor(done));
+    QVERIFY(dropArea->checkSanity());
+    const Rect group1Geometry = dock1->dptr()->group()->geometry();
+    const Rect group3Geometry = dock3->dptr()->group()->geometry();
+    dropArea->layoutEqually();
+    QCOMPARE(dock1->dptr()->group()->geometry(), group1Geometry);
+    QCOMPARE(dock3->dptr()->group()->geometry(), group3Geometry);
+
+    // Resizing
+    const Size originalSize = dropArea->layoutSize();
+    const Size biggerSize = originalSize + Size(200, 100);
+    done = false;
+    dropArea->setLayoutSizeAsync(biggerSize, [&done] { done = true; });
+    QVERIFY(!done);
+    QCOMPARE(dropArea->layoutSize(), originalSize);
+    QVERIFY(waitFor(done));
+    QCOMPARE(dropArea->layoutSize(), biggerSize);
+    QVERIFY(dropArea->checkSanity());
+
+    // A newer size was requested meanwhile, the older result is discarded, even if the layout
+    // didn't change
+    done = false;
+    dropArea->setLayoutSizeAsync(originalSize, [&done] { done = true; });
+    dropArea->setLayoutSize(biggerSize);
+    QVERIFY(waitFor(done));
+    QCOMPARE(dropArea->layoutSize(), biggerSize);
+
+    // Same, but the layout changed, so the fallback path doesn't undo the newer size either
+    done = false;
+    const Size smallerSize = biggerSize - Size(50, 50);
+    dropArea->setLayoutSizeAsync(originalSize, [&done] { done = true; });
+    dropArea->setLayoutSize(smallerSize);
+    QVERIFY(waitFor(done));
+    QCOMPARE(dropArea->layoutSize(), smallerSize);
+    QVERIFY(dropArea->checkSanity());
+}
+
+void TestDocks::tst_topLevelZOrder()
+{
+    EnsureTopLevelsDeleted e;
+    auto dock1 = createDockWidget("dock1");
+    auto dock2 = createDockWidget("dock2");
+    auto fw1 = dock1->floatingWindow();
+    auto fw2 = dock2->floatingWindow();
+    fw1->view()->setGeometry(Rect(100, 100, 400, 400));
+    fw2->view()->setGeometry(Rect(300, 300, 400, 400));
+
+    auto registry = DockRegistry::self();
+    Core::EventFilterInterface *filter = registry;
+    const Point overlap(400, 400);
+
+    // An exposed window goes to the top
+    filter->onExposeEvent(fw1->view()->window());
+    QCOMPARE(registry->topLevelAt(overlap)->controller(), fw1);
+    filter->onExposeEvent(fw2->view()->window());
+    QCOMPARE(registry->topLevelAt(overlap)->controller(), fw2);
+
+    QCOMPARE(registry->topLevelAt(overlap, fw2->view())->controller(), fw1);
+    QCOMPARE(registry->topLevelAt(Point(150, 150))->controller(), fw1);
+    QVERIFY(!registry->topLevelAt(Point(50, 50)));
+
+    // While frozen, the cached geometry is used
+    registry->setTopLevelGeometriesFrozen(true);
+    fw2->view()->setGeometry(Rect(600, 600, 400, 400));
+    QCOMPARE(registry->topLevelAt(overlap)->controller(), fw2);
+    registry->setTopLevelGeometriesFrozen(false);
+    QCOMPARE(registry->topLevelAt(overlap)->controller(), fw1);
+
+    // Hidden windows are skipped
+    fw1->view()->hide();
+    QVERIFY(!registry->topLevelAt(overlap));
+
+    delete fw1;
+    delete fw2;
+}
+
+void TestDocks::tst_memoryUsage()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None, "mw1");
+    auto dock1 = createDockWidget("dock1");
+    auto dock2 = createDockWidget("dock2");
+    auto dock3 = createDockWidget("dock3");
+    m->addDockWidget(dock1, KDDockWidgets::Location_OnLeft);
+    m->addDockWidget(dock2, KDDockWidgets::Location_OnRight);
+
+    auto usage = DockRegistry::self()->memoryUsage();
+    QCOMPARE(usage.layouts.size(), 2);
+    QCOMPARE(usage.floatingWindows.count, 1);
+
+    const DockRegistry::MemoryUsage::LayoutUsage &mainWindowUsage = usage.layouts.first();
+    QCOMPARE(mainWindowUsage.mainWindowName, QString("mw1"));
+    QCOMPARE(mainWindowUsage.groups.count, 2);
+    QCOMPARE(mainWindowUsage.titleBars.count, 2);
+    QCOMPARE(mainWindowUsage.separators.count, 1);
+    QCOMPARE(mainWindowUsage.placeholderItems.count, 0);
+    QVERIFY(mainWindowUsage.totalBytes() > 0);
+    QVERIFY(usage.totalBytes() > mainWindowUsage.totalBytes());
+
+    // Closing leaves a placeholder behind
+    dock1->close();
+    usage = DockRegistry::self()->memoryUsage();
+    QCOMPARE(usage.layouts.first().groups.count, 1);
+    QCOMPARE(usage.layouts.first().placeholderItems.count, 1);
+    QVERIFY(usage.positions.count >= 1);
+
+    delete dock3->floatingWindow();
+    usage = DockRegistry::self()->memoryUsage();
+    QCOMPARE(usage.layouts.size(), 1);
+    QCOMPARE(usage.floatingWindows.count, 0);
+}
+
 void TestDocks::tst_floatMaintainsSize()
 {
     // Tests that when we make a window float by pressing the float button, it will popup with
@@ -2359,6 +2911,43 @@ void TestDocks::tst_tabTitleChanges()
     QCOMPARE(tb->text(0), QStringLiteral("other"));
 }
 
+void TestDocks::tst_coalescedTitleChanges()
+{
+    EnsureTopLevelsDeleted e;
+    KDDockWidgets::Config::self().setFlags(KDDockWidgets::Config::Flag_CoalesceTitleChanges);
+
+    auto m = createMainWindow(Size(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("1");
+    auto dock2 = createDockWidget("2");
+    m->addDockWidget(dock1, Location_OnLeft);
+    dock1->addDockWidgetAsTab(dock2);
+    dock1->setAsCurrentTab();
+
+    Core::TabBar *tb = dock1->dptr()->group()->tabBar();
+    Core::TitleBar *titleBar = dock1->dptr()->group()->titleBar();
+
+    int numTitleChanges = 0;
+    KDBindings::ScopedConnection connection = titleBar->dptr()->titleChanged.connect([&numTitleChanges] { ++numTitleChanges; });
+
+    for (int i = 0; i < 10; ++i) {
+        dock1->setTitle(QStringLiteral("value %1").arg(i));
+        dock2->setTitle(QStringLiteral("other %1").arg(i));
+    }
+
+    // The dock widget itself is up to date right away, its views aren't
+    QCOMPARE(dock1->title(), QStringLiteral("value 9"));
+    QCOMPARE(tb->text(0), QStringLiteral("1"));
+    QCOMPARE(numTitleChanges, 0);
+
+    Platform::instance()->tests_wait(100);
+
+    // Only the final values were propagated
+    QCOMPARE(tb->text(0), QStringLiteral("value 9"));
+    QCOMPARE(tb->text(1), QStringLiteral("other 9"));
+    QCOMPARE(titleBar->title(), QStringLiteral("value 9"));
+    QCOMPARE(numTitleChanges, 1);
+}
+
 void TestDocks::tst_setWidget()
 {
     EnsureTopLevelsDeleted e;
@@ -3553,6 +4142,56 @@ void TestDocks::tst_restoreWithDockFactory2()
     saver.restoreLayout(saved);
 }
 
+void TestDocks::tst_restoreWithDockBatchFactory()
+{
+    // Tests that the batch factory gets all missing dock widgets at once
+
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(Size(501, 500), MainWindowOption_None);
+    auto layout = m->multiSplitter();
+
+    auto dock1 = createDockWidget("dw1", Platform::instance()->tests_createView({ true }));
+    auto dock2 = createDockWidget("dw2", Platform::instance()->tests_createView({ true }));
+    auto dock3 = createDockWidget("dw3", Platform::instance()->tests_createView({ true }));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    m->addDockWidget(dock3, Location_OnBottom);
+
+    LayoutSaver saver;
+    const QByteArray saved = saver.serializeLayout();
+    delete dock1;
+    delete dock2;
+
+    static Vector<QString> s_requestedNames;
+    static int s_numSingleRequests = 0;
+    s_requestedNames.clear();
+    s_numSingleRequests = 0;
+
+    DockWidgetBatchFactoryFunc batchFunc = [](const Vector<QString> &names) {
+        s_requestedNames = names;
+        for (const QString &name : names)
+            createDockWidget(name, Platform::instance()->tests_createView({ true }), {}, {},
+                             /*show=*/false);
+    };
+
+    DockWidgetFactoryFunc func = [](const QString &) -> Core::DockWidget * {
+        s_numSingleRequests++;
+        return nullptr;
+    };
+
+    KDDockWidgets::Config::self().setDockWidgetBatchFactoryFunc(batchFunc);
+    KDDockWidgets::Config::self().setDockWidgetFactoryFunc(func);
+    QVERIFY(saver.restoreLayout(saved));
+    KDDockWidgets::Config::self().setDockWidgetBatchFactoryFunc(nullptr);
+    KDDockWidgets::Config::self().setDockWidgetFactoryFunc(nullptr);
+
+    // dw3 still existed
+    QCOMPARE(s_requestedNames, Vector<QString>({ "dw1", "dw2" }));
+    QCOMPARE(s_numSingleRequests, 0);
+    QCOMPARE(layout->visibleCount(), 3);
+    QVERIFY(layout->checkSanity());
+}
+
 void TestDocks::tst_addDockWidgetToMainWindow()
 {
     EnsureTopLevelsDeleted e;
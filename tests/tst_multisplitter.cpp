@@ -13,6 +13,9 @@
 #include "core/layouting/LayoutingHost_p.h"
 #include "core/layouting/LayoutingGuest_p.h"
 #include "core/layouting/LayoutingSeparator_p.h"
+#include "core/layouting/SizingKernels_p.h"
+#include "core/layouting/Allocators_p.h"
+#include "core/layouting/LayoutSolver_p.h"
 #include "core/DropArea.h"
 #include "core/View_p.h"
 #include "core/Utils_p.h"
@@ -23,6 +26,7 @@
 
 #include <memory.h>
 #include <cstdlib>
+#include <random>
 #include <utility>
 
 using namespace KDDockWidgets;
@@ -87,6 +91,10 @@ private Q_SLOTS:
     void tst_adjacentLayoutBorders();
     void tst_numSideBySide_recursive();
     void tst_sizingInfoSerialization();
+    void tst_sizingKernels();
+    void tst_allocators();
+    void tst_rareSignals();
+    void tst_layoutSolver();
     void tst_itemSerialization();
     void tst_relayoutIfNeeded();
     void tst_outermostVisibleNeighbor();
@@ -2084,6 +2092,236 @@ void TestLayouting::tst_itemSerialization()
     QVERIFY(!json["children"][1]["isContainer"]);
 }
 
+void TestLayouting::tst_sizingKernels()
+{
+    // Tests that the structure-of-arrays kernels give exactly the same results as the
+    // original implementations, for random sizes and constraints
+
+    std::mt19937 rng(42);
+    auto random = [&rng](int min, int max) {
+        return std::uniform_int_distribution<int>(min, max)(rng);
+    };
+
+    for (int iteration = 0; iteration < 5000; ++iteration) {
+        const int count = random(1, 16);
+        const Qt::Orientation o = random(0, 1) ? Qt::Vertical : Qt::Horizontal;
+
+        SizingInfo::List sizes;
+        int sumOfMins = 0;
+        for (int i = 0; i < count; ++i) {
+            SizingInfo info;
+            const int min = random(1, 150);
+            const int max = random(0, 3) == 0 ? random(min, min + 400) : Item::hardcodedMaximumSize.width();
+            const int length = random(0, 800);
+            info.minSize = { min, min };
+            info.maxSizeHint = { max, max };
+            info.geometry = Rect(0, 0, length, length);
+            sizes.push_back(info);
+            sumOfMins += min;
+        }
+
+        {
+            // There's always enough space for the mins, as in a real layout
+            const int lengthToGive = sumOfMins + random(0, 3000);
+            SizingInfo::List expected = sizes;
+            SizingKernels::Reference::layoutEqually(expected, o, lengthToGive);
+
+            SizingInfo::List actual = sizes;
+            SizingArrays arrays(actual, o);
+            SizingKernels::layoutEqually(arrays, lengthToGive);
+            arrays.applyLengths(actual);
+
+            for (int i = 0; i < count; ++i)
+                QCOMPARE(actual.at(i).geometry, expected.at(i).geometry);
+        }
+
+        {
+            const int containerLength = random(100, 5000);
+            SizingInfo::List expected = sizes;
+            SizingKernels::Reference::honourMaxSizes(expected, o, containerLength);
+
+            SizingInfo::List actual = sizes;
+            SizingArrays arrays(actual, o);
+            SizingKernels::honourMaxSizes(arrays, containerLength);
+            arrays.applyLengths(actual);
+
+            for (int i = 0; i < count; ++i)
+                QCOMPARE(actual.at(i).geometry, expected.at(i).geometry);
+        }
+
+        {
+            Vector<int> availabilities;
+            int sumOfAvailabilities = 0;
+            for (int i = 0; i < count; ++i) {
+                const int available = random(0, 3) == 0 ? 0 : random(0, 300);
+                availabilities.push_back(available);
+                sumOfAvailabilities += available;
+            }
+
+            if (sumOfAvailabilities == 0)
+                continue;
+
+            const int needed = random(1, sumOfAvailabilities);
+            const auto strategy = random(0, 1) ? NeighbourSqueezeStrategy::AllNeighbours
+                                               : NeighbourSqueezeStrategy::ImmediateNeighboursFirst;
+            const bool reversed = random(0, 1);
+
+            const Vector<int> expected =
+                SizingKernels::Reference::calculateSqueezes(availabilities, needed, strategy, reversed);
+
+            Vector<int> actual(count, 0);
+            const int missing = SizingKernels::calculateSqueezes(
+                availabilities.data(), actual.data(), count, needed, strategy, reversed);
+
+            QCOMPARE(missing, 0);
+            QCOMPARE(actual, expected);
+        }
+    }
+}
+
+void TestLayouting::tst_allocators()
+{
+    DeleteViews deleteViews;
+
+    {
+        // Items and their privates come from the pool, and are returned to it
+        auto pool = PoolAllocator::self();
+        const size_t initialBlocks = pool->numAllocatedBlocks();
+        {
+            auto root = createRoot();
+            for (int i = 0; i < 20; ++i)
+                root->insertItem(createItem(), Location_OnRight);
+            QVERIFY(pool->numAllocatedBlocks() > initialBlocks + 20);
+        }
+        QCOMPARE(pool->numAllocatedBlocks(), initialBlocks);
+    }
+
+    {
+        // Scratch buffers are released when their scope ends, and then reused
+        int *outer = nullptr;
+        int *inner = nullptr;
+        {
+            ScratchBuffer::Scope scope;
+            outer = ScratchBuffer::allocateInts(10);
+            {
+                ScratchBuffer::Scope innerScope;
+                inner = ScratchBuffer::allocateInts(10);
+                QCOMPARE(inner, outer + 10);
+
+                // Bigger than a block, outer and inner stay valid
+                int *big = ScratchBuffer::allocateInts(100000);
+                big[99999] = 1;
+                inner[0] = 2;
+                outer[0] = 3;
+                QCOMPARE(inner[0], 2);
+                QCOMPARE(outer[0], 3);
+            }
+
+            QCOMPARE(ScratchBuffer::allocateInts(10), inner);
+        }
+
+        ScratchBuffer::Scope scope;
+        QCOMPARE(ScratchBuffer::allocateInts(10), outer);
+    }
+}
+
+void TestLayouting::tst_rareSignals()
+{
+    DeleteViews deleteViews;
+
+    auto root = createRoot();
+    auto item1 = createItem();
+    auto item2 = createItem();
+    auto item3 = createItem();
+    root->insertItem(item1, Location_OnLeft);
+    root->insertItem(item2, Location_OnRight);
+    ItemBoxContainer::insertItemRelativeTo(item3, item2, Location_OnBottom);
+
+    // Only allocated when needed
+    QVERIFY(!item1->hasRareSignals());
+    QVERIFY(!item3->hasRareSignals());
+
+    Rect oldGeometry;
+    Rect newGeometry;
+    int numDeltas = 0;
+    KDBindings::ScopedConnection deltaConnection =
+        item1->rareSignals().geometryDelta.connect([&](Rect oldGeo, Rect newGeo) {
+            oldGeometry = oldGeo;
+            newGeometry = newGeo;
+            numDeltas++;
+        });
+
+    // item3 is inside a nested container, it moves when the container moves
+    int numXChanged = 0;
+    KDBindings::ScopedConnection xConnection =
+        item3->rareSignals().xChanged.connect([&numXChanged] { numXChanged++; });
+
+    QVERIFY(item1->hasRareSignals());
+    QVERIFY(!item2->hasRareSignals());
+
+    root->setSize_recursive(root->size() + Size(200, 0));
+    QVERIFY(root->checkSanity());
+
+    QVERIFY(numDeltas > 0);
+    QVERIFY(oldGeometry != newGeometry);
+    QCOMPARE(newGeometry, item1->geometry());
+    QVERIFY(numXChanged > 0);
+}
+
+void TestLayouting::tst_layoutSolver()
+{
+    DeleteViews deleteViews;
+
+    auto root = createRoot();
+    auto item1 = createItem();
+    auto item2 = createItem(Size(300, 100));
+    auto item3 = createItem();
+    auto item4 = createItem();
+    root->insertItem(item1, Location_OnLeft);
+    root->insertItem(item2, Location_OnRight);
+    ItemBoxContainer::insertItemRelativeTo(item3, item2, Location_OnBottom);
+    ItemBoxContainer::insertItemRelativeTo(item4, item3, Location_OnRight);
+    QVERIFY(root->checkSanity());
+
+    // The same operations, done directly, for comparison
+    ItemBoxContainer expected(nullptr);
+    expected.fillFromItem(root.get());
+    expected.setSize_recursive(root->size() + Size(300, 150));
+    expected.layoutEqually_recursive();
+
+    {
+        LayoutSolver solver(root.get());
+        solver.setSize_recursive(root->size() + Size(300, 150));
+        solver.layoutEqually_recursive();
+        solver.solveAsync().wait();
+
+        // The real layout isn't touched until apply()
+        QCOMPARE(root->size(), Size(1000, 1000));
+
+        QVERIFY(solver.apply());
+        QVERIFY(root->checkSanity());
+
+        const Item::List items = root->items_recursive();
+        const Item::List expectedItems = expected.items_recursive();
+        QCOMPARE(items.size(), expectedItems.size());
+        for (int i = 0; i < items.size(); ++i)
+            QCOMPARE(items.at(i)->mapToRoot(items.at(i)->rect()),
+                     expectedItems.at(i)->mapToRoot(expectedItems.at(i)->rect()));
+    }
+
+    {
+        // Layout changed while solving, the result is discarded
+        LayoutSolver solver(root.get());
+        solver.layoutEqually_recursive();
+        solver.solve();
+        root->setSize_recursive(root->size() + Size(10, 10));
+        const Rect item1Geometry = item1->geometry();
+        QVERIFY(!solver.apply());
+        QCOMPARE(item1->geometry(), item1Geometry);
+        QVERIFY(root->checkSanity());
+    }
+}
+
 void TestLayouting::tst_outermostVisibleNeighbor()
 {
     DeleteViews deleteViews;
@@ -12,8 +12,10 @@
 #include "core/View_p.h"
 #include "core/ViewFactory.h"
 #include "core/Platform.h"
+#include "core/EventFilterInterface.h"
 #include "Config.h"
 
+#include <QMouseEvent>
 #include <QTest>
 #include <string>
 
@@ -28,6 +30,7 @@ private Q_SLOTS:
     void tst_name();
     void tst_createDefaultViewFactory();
     void tst_startDragDistance();
+    void tst_globalEventFilterInterests();
 };
 
 void TestPlatform::tst_platform()
@@ -62,6 +65,50 @@ void TestPlatform::tst_startDragDistance()
     QCOMPARE(plat->startDragDistance(), newDistance);
 }
 
+void TestPlatform::tst_globalEventFilterInterests()
+{
+    // Tests that global event filters only receive the events they're interested in
+
+    class PressFilter : public EventFilterInterface
+    {
+    public:
+        int eventInterests() const override
+        {
+            return EventInterest_MouseButtonPress;
+        }
+
+        bool onMouseEvent(View *, MouseEvent *) override
+        {
+            ++numMouseEvents;
+            return false;
+        }
+
+        int numMouseEvents = 0;
+    };
+
+    auto plat = Platform::instance();
+    View *view = plat->tests_createView({ true });
+
+    PressFilter filter;
+    plat->installGlobalEventFilter(&filter);
+
+    QMouseEvent move(QEvent::MouseMove, QPointF(1, 1), QPointF(1, 1), Qt::NoButton, Qt::NoButton,
+                     Qt::NoModifier);
+    plat->sendEvent(view, &move);
+    QCOMPARE(filter.numMouseEvents, 0);
+
+    QMouseEvent press(QEvent::MouseButtonPress, QPointF(1, 1), QPointF(1, 1), Qt::LeftButton,
+                      Qt::LeftButton, Qt::NoModifier);
+    plat->sendEvent(view, &press);
+    QCOMPARE(filter.numMouseEvents, 1);
+
+    plat->removeGlobalEventFilter(&filter);
+    plat->sendEvent(view, &press);
+    QCOMPARE(filter.numMouseEvents, 1);
+
+    delete view;
+}
+
 #define KDDW_TEST_NAME TestPlatform
 #include "test_main_qt.h"
 
@@ -42,6 +42,7 @@ private Q_SLOTS:
     void tst_viewFocusPolicy();
     void tst_hasFocus();
     void tst_parentDeletesChildViews();
+    void tst_wrappersAreCached();
 };
 
 void TestView::tst_viewSetParent()
@@ -273,6 +274,28 @@ void TestView::tst_parentDeletesChildViews()
     QVERIFY(!guard2);
 }
 
+void TestView::tst_wrappersAreCached()
+{
+    // Tests that wrapping the same view or window twice returns the same wrapper
+
+    auto rootView = createViewAndWindow({});
+    auto childView = createViewAndWindow({}, rootView);
+
+    auto parent1 = childView->parentView();
+    auto parent2 = childView->parentView();
+    QVERIFY(parent1);
+    QCOMPARE(parent1.get(), parent2.get());
+    QCOMPARE(rootView->asWrapper().get(), parent1.get());
+    QVERIFY(parent1->equals(rootView));
+
+    auto window1 = rootView->window();
+    auto window2 = childView->window();
+    QVERIFY(window1);
+    QCOMPARE(window1.get(), window2.get());
+
+    delete rootView;
+}
+
 #define KDDW_TEST_NAME TestView
 #include "test_main_qt.h"
 
@@ -122,6 +122,7 @@ struct EnsureTopLevelsDeleted
         Config::self().setMDIFlags(m_originalMDIFlags);
         Config::self().setSeparatorThickness(m_originalSeparatorThickness);
         Config::self().setLayoutSaverStrictMode(false);
+        Config::self().setMaxPlaceholdersPerLayout(0);
         InitialOption::s_defaultNeighbourSqueezeStrategy = NeighbourSqueezeStrategy::AllNeighbours;
     }
 